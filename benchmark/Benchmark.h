@@ -0,0 +1,87 @@
+#pragma once
+#ifndef MEAT_WAGONS_BENCHMARK_H
+#define MEAT_WAGONS_BENCHMARK_H
+
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+#include <random>
+#include <string>
+#include <set>
+#include "../src/MeatWagons/Request.h"
+#include "../src/Graph/Reader.h"
+
+using namespace std;
+
+/**
+ * @brief Reads a map of maps/PortugalMaps and pre processes it from its central, like the application does
+ * @param name - name of the map (Fafe, Porto, Lisboa, ...)
+ * @param graph - graph where the map is stored
+ * @param central - id of the central of the map
+ * @return - true if the map was read and pre processed
+ */
+bool readMap(const string &name, Graph &graph, int &central) {
+    Reader reader("maps/PortugalMaps/" + name);
+    if(!reader.readGraph(&graph, central)) {
+        cerr << "Can't read maps/PortugalMaps/" << name << " (run the benchmarks from the repository root)" << endl;
+        return false;
+    }
+    return graph.preProcess(central);
+}
+
+/**
+ * @brief Pairs of vertexes about length edges apart, found by random walks from random vertexes
+ * @param graph - graph of the map
+ * @param count - number of pairs
+ * @param length - number of edges of each walk
+ * @param seed - seed of the random walks
+ * @return - ids of the vertexes of each pair
+ */
+vector<pair<int, int>> randomWalkPairs(const Graph &graph, const int count, const int length, const unsigned seed) {
+    const vector<Vertex*> &vertexSet = graph.getVertexSet();
+    mt19937 random(seed);
+    vector<pair<int, int>> pairs;
+
+    while((int) pairs.size() < count) {
+        Vertex *origin = vertexSet[random() % vertexSet.size()], *dest = origin;
+        for(int i = 0; i < length && !dest->getAdj().empty(); i++)
+            dest = dest->getAdj()[random() % dest->getAdj().size()].getDest();
+        if(origin != dest) pairs.push_back(make_pair(origin->getId(), dest->getId()));
+    }
+
+    return pairs;
+}
+
+/**
+ * @brief Pairs of random vertexes of the graph
+ * @param graph - graph of the map
+ * @param count - number of pairs
+ * @param seed - seed of the random choices
+ * @return - ids of the vertexes of each pair
+ */
+vector<pair<int, int>> randomPairs(const Graph &graph, const int count, const unsigned seed) {
+    const vector<Vertex*> &vertexSet = graph.getVertexSet();
+    mt19937 random(seed);
+    vector<pair<int, int>> pairs;
+
+    for(int i = 0; i < count; i++) {
+        int origin = vertexSet[random() % vertexSet.size()]->getId();
+        pairs.push_back(make_pair(origin, vertexSet[random() % vertexSet.size()]->getId()));
+    }
+
+    return pairs;
+}
+
+/**
+ * @brief Runs a function and measures how long it takes
+ * @param function - function to run
+ * @return - time taken, in milliseconds
+ */
+template <typename Function>
+double measure(Function function) {
+    auto start = chrono::steady_clock::now();
+    function();
+    return chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+}
+
+#endif
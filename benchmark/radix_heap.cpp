@@ -0,0 +1,104 @@
+#include <algorithm>
+#include "Benchmark.h"
+
+/*
+ * Full single-source searches with the binary heap (MutablePriorityQueue, the default SearchQueue of the graph) and
+ * with the radix heap (SearchQueue when GRAPH_RADIX_HEAP is defined), from random sources, interleaved so both see
+ * the same state of the caches. Prints the median time of each queue.
+ * Usage: bench_radix_heap [runs] [map...] (default: 300 Fafe Porto Lisboa)
+ */
+
+// edges of the graph in both directions, in contiguous arrays like the csr of the graph
+struct Adjacency {
+    vector<int> offsets, targets;
+    vector<double> weights;
+
+    Adjacency(const Graph &graph) {
+        int numVertex = graph.getNumVertex();
+        vector<vector<pair<int, double>>> neighbours(numVertex);
+        for(Vertex *vertex : graph.getVertexSet())
+            for(const Edge &edge : vertex->getAdj()) {
+                neighbours[vertex->getIndex()].push_back(make_pair(edge.getDest()->getIndex(), edge.getWeight()));
+                neighbours[edge.getDest()->getIndex()].push_back(make_pair(vertex->getIndex(), edge.getWeight()));
+            }
+
+        offsets.push_back(0);
+        for(const vector<pair<int, double>> &list : neighbours) {
+            for(const pair<int, double> &next : list) {
+                targets.push_back(next.first);
+                weights.push_back(next.second);
+            }
+            offsets.push_back(targets.size());
+        }
+    }
+};
+
+/**
+ * @brief Dijkstra from a vertex to every other one with the given queue
+ * @param adjacency - edges of the graph
+ * @param source - index of the vertex where the search starts
+ * @param dist - filled with the distance of each vertex
+ * @param queueIndex - scratch array of the queue
+ * @return - sum of the distances of the vertexes reached, so the search can't be optimized away
+ */
+template <class Queue>
+double search(const Adjacency &adjacency, const int source, vector<double> &dist, vector<int> &queueIndex) {
+    dist.assign(adjacency.offsets.size() - 1, numeric_limits<double>::infinity());
+    queueIndex.assign(dist.size(), 0);
+    Queue queue(dist, queueIndex);
+    dist[source] = 0;
+    queue.insert(source);
+
+    double sum = 0;
+    while(!queue.empty()) {
+        int vertex = queue.extractMin();
+        sum += dist[vertex];
+        for(int arc = adjacency.offsets[vertex]; arc < adjacency.offsets[vertex + 1]; arc++) {
+            int next = adjacency.targets[arc];
+            if(dist[vertex] + adjacency.weights[arc] < dist[next]) {
+                bool queued = dist[next] != numeric_limits<double>::infinity();
+                dist[next] = dist[vertex] + adjacency.weights[arc];
+                if(queued) queue.decreaseKey(next);
+                else queue.insert(next);
+            }
+        }
+    }
+
+    return sum;
+}
+
+double median(vector<double> &times) {
+    sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+int main(int argc, char *argv[]) {
+    int runs = argc > 1 ? atoi(argv[1]) : 300;
+    vector<string> maps;
+    for(int i = 2; i < argc; i++) maps.push_back(argv[i]);
+    if(maps.empty()) maps = {"Fafe", "Porto", "Lisboa"};
+
+    cout << fixed << setprecision(3);
+    for(const string &map : maps) {
+        Graph graph;
+        int central;
+        if(!readMap(map, graph, central)) return 1;
+
+        Adjacency adjacency(graph);
+        vector<pair<int, int>> sources = randomPairs(graph, runs, 7);
+        vector<double> dist, binaryTimes, radixTimes;
+        vector<int> queueIndex;
+        double binarySum = 0, radixSum = 0;
+
+        for(const pair<int, int> &query : sources) {
+            int source = graph.findVertexIndex(query.first);
+            binaryTimes.push_back(measure([&]() { binarySum += search<MutablePriorityQueue<double>>(adjacency, source, dist, queueIndex); }));
+            radixTimes.push_back(measure([&]() { radixSum += search<RadixHeap>(adjacency, source, dist, queueIndex); }));
+        }
+
+        cout << setw(8) << map << "  binary " << median(binaryTimes) << " ms  radix " << median(radixTimes) << " ms"
+             << (abs(binarySum - radixSum) > 1e-6 * binarySum ? "  (different distances!)" : "") << endl;
+    }
+
+    return 0;
+}
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <thread>
+#include "Benchmark.h"
+
+/*
+ * Scaling of the parallel work of the graph with the number of workers: a batch of shortestPaths (dijkstra and
+ * contraction hierarchy queries) and a poiMatrix, each run on schedulers of 1, 2, 4 and one worker per core.
+ * Prints the median time of each one and the speedup over a single worker.
+ * Usage: bench_scheduler_scaling [runs] [map...] (default: 5 Porto Lisboa)
+ */
+
+double median(vector<double> &times) {
+    sort(times.begin(), times.end());
+    return times[times.size() / 2];
+}
+
+int main(int argc, char *argv[]) {
+    int runs = argc > 1 ? max(1, atoi(argv[1])) : 5;
+    vector<string> maps;
+    for(int i = 2; i < argc; i++) maps.push_back(argv[i]);
+    if(maps.empty()) maps = {"Porto", "Lisboa"};
+
+    set<int> workerCounts = {1, 2, 4, (int) max(1u, thread::hardware_concurrency())};
+    cout << fixed << setprecision(2);
+
+    for(const string &map : maps) {
+        Graph graph;
+        int central;
+        if(!readMap(map, graph, central)) return 1;
+
+        vector<Graph::PathQuery> queries;
+        for(const pair<int, int> &query : randomPairs(graph, 200, 7))
+            queries.push_back({query.first, query.second, Graph::DIJKSTRA});
+        for(const pair<int, int> &query : randomPairs(graph, 2000, 11))
+            queries.push_back({query.first, query.second, Graph::CONTRACTION_HIERARCHY});
+
+        vector<int> points;
+        for(const pair<int, int> &point : randomPairs(graph, 100, 13)) points.push_back(point.first);
+
+        // builds what the queries need (csr, contraction hierarchy) before anything is measured
+        vector<Graph::PathResult> results;
+        graph.shortestPaths(queries, results);
+
+        double batchSingle = 0, matrixSingle = 0;
+        for(int numWorkers : workerCounts) {
+            TaskScheduler scheduler(numWorkers);
+            graph.setScheduler(scheduler);
+
+            vector<double> batchTimes, matrixTimes;
+            for(int run = 0; run < runs; run++) {
+                PoiMatrix matrix;
+                batchTimes.push_back(measure([&]() { graph.shortestPaths(queries, results); }));
+                matrixTimes.push_back(measure([&]() { graph.poiMatrix(matrix, points); }));
+            }
+            graph.setScheduler(TaskScheduler::shared());
+
+            double batch = median(batchTimes), matrix = median(matrixTimes);
+            if(numWorkers == 1) {
+                batchSingle = batch;
+                matrixSingle = matrix;
+            }
+
+            cout << setw(8) << map << "  " << setw(2) << numWorkers << " workers  batch " << setw(9) << batch
+                 << " ms (x" << batchSingle / batch << ")  poi matrix " << setw(9) << matrix
+                 << " ms (x" << matrixSingle / matrix << ")" << endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include "Benchmark.h"
+
+/*
+ * Cost of a query when the search state is reset lazily: on short legs only the few vertexes touched by the search
+ * are reset, so the time per query doesn't depend on the size of the map. Long random queries settle a large part
+ * of the map and are shown for comparison.
+ * Usage: bench_search_reset [map...] (default: Porto Lisboa)
+ */
+int main(int argc, char *argv[]) {
+    vector<string> maps;
+    for(int i = 1; i < argc; i++) maps.push_back(argv[i]);
+    if(maps.empty()) maps = {"Porto", "Lisboa"};
+
+    const string names[] = {"dijkstra", "A*", "bidirectional"};
+    cout << fixed << setprecision(1);
+
+    for(const string &map : maps) {
+        Graph graph;
+        int central;
+        if(!readMap(map, graph, central)) return 1;
+
+        vector<pair<int, int>> shortPairs = randomWalkPairs(graph, 1000, 15, 7);
+        vector<pair<int, int>> longPairs = randomPairs(graph, 100, 7);
+
+        for(const vector<pair<int, int>> *pairs : {&shortPairs, &longPairs}) {
+            for(int algorithm = 0; algorithm < 3; algorithm++) {
+                long long pathEdges = 0;
+                double time = measure([&]() {
+                    for(const pair<int, int> &query : *pairs) {
+                        unordered_set<int> processedEdges, processedEdgesInv;
+                        if(algorithm == 0) graph.dijkstra(query.first, query.second, processedEdges);
+                        else if(algorithm == 1) graph.dijkstraOrientedSearch(query.first, query.second, processedEdges);
+                        else graph.dijkstraBidirectional(query.first, query.second, processedEdges, processedEdgesInv);
+
+                        vector<Edge> edges;
+                        pathEdges += graph.getPathTo(query.second, edges);
+                    }
+                });
+
+                cout << setw(8) << map << (pairs == &shortPairs ? "  short " : "  long  ") << setw(14) << names[algorithm]
+                     << setw(10) << time * 1000 / pairs->size() << " us/query  (" << pathEdges << " path edges)" << endl;
+            }
+        }
+    }
+
+    return 0;
+}
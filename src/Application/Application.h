@@ -111,11 +111,14 @@ void Application::shortestPath() {
 		cout << endl << "1 - Classic Dijkstra";
 		cout << endl << "2 - Oriented Dijkstra (A*)";
 		cout << endl << "3 - Bidirectional Dijkstra";
+		cout << endl << "4 - Contraction Hierarchies";
+		cout << endl << "5 - Arc Flags";
+		cout << endl << "6 - Customizable Contraction Hierarchies";
 		cout << endl << "\bInput: > ";
 		readline(input);
 		
 		if(input == "back") break;
-		else if(stoint(input, choice) == 0 && choice >= 1 && choice <= 3) {
+		else if(stoint(input, choice) == 0 && choice >= 1 && choice <= 6) {
 			int origin, dest;
 			cout << endl << "\nProvide <origin node> <destination node> [Example: 90379359 411018963]";
 			cout << endl << "\bInput: > ";
@@ -204,8 +207,8 @@ void Application::deliver() {
 						int delivery;
 						while (true) {
 							cout << endl << "--- Choose a Delivery done by Wagon #" << wagonID << " --- ";
-                            int delivIndexMax;
-                            for(auto w : wagons)
+                            int delivIndexMax = -1;
+                            for(const auto &w : wagons)
                                 if(wagonID == w.getId()) {
                                     delivIndexMax = w.getDeliveries().size()-1;
                                 }
@@ -326,7 +329,7 @@ void Application::wagonOperation() {
 	return;
 }
 void Application::listRequests() {
-	multiset<Request*> requests = controller->getConstantRequests();
+	const multiset<Request*> &requests = controller->getConstantRequests();
     if(!requests.empty()) {
         cout << "\n--- List Requests ---" << endl;
         for (auto request : requests) {
@@ -0,0 +1,237 @@
+#pragma once
+#ifndef ARC_FLAGS_H_
+#define ARC_FLAGS_H_
+
+#include <vector>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include <limits>
+#include <cstdint>
+#include "CSRGraph.h"
+#include "TaskScheduler.h"
+
+using namespace std;
+
+/**
+ * Arc flags: the vertexes are split into cells by their position, and each arc keeps one bit per cell, set if the
+ * arc starts a shortest path to some vertex of the cell. A search to a vertex of a cell only follows the arcs with
+ * the bit of that cell set, so it leaves out most of the graph and still finds a shortest path.
+ * Like the searches, the arcs are followed in both directions, so the outgoing and the ingoing arcs of a vertex
+ * have separate flags (the flag of an ingoing arc is about following it from its target to its origin).
+ * The flags of a cell are set by a search from each boundary vertex of the cell (a vertex with a neighbour in
+ * another cell): every shortest path that enters the cell passes through one of them.
+ */
+class ArcFlags {
+public:
+    const static int maxCells = 64;  // one bit per cell in a 64 bit word
+
+private:
+    vector<int> cells;              // cell of each vertex
+    vector<uint64_t> flags;         // flags of each outgoing arc, bit c set if the arc leads to the cell c
+    vector<uint64_t> invFlags;      // flags of each ingoing arc
+    int numCells = 0;
+
+    void partition(const CSRGraph &csr, vector<int> &vertexes, const int first, const int last, const int firstCell, const int count);
+    void flagPaths(const CSRGraph &csr, const int boundary, vector<double> &dist, vector<uint64_t> &arcFlags, vector<uint64_t> &invArcFlags) const;
+
+public:
+    void build(const CSRGraph &csr, const int numCells, TaskScheduler &scheduler);
+    void clear();
+
+    int getNumCells() const;
+    int getCell(const int vertex) const;
+    inline bool leadsTo(const int arc, const int cell) const;
+    inline bool invLeadsTo(const int arc, const int cell) const;
+    size_t getMemoryUsage() const;
+};
+
+/**
+ * @brief Splits the vertexes of a range into cells of about the same size, by halving the range recursively across
+ * the longest side of the rectangle around its vertexes (a kd-tree)
+ * @param csr - CSR arrays of the graph, with the coordinates of the vertexes
+ * @param vertexes - indexes of the vertexes, reordered so each cell is a sub range
+ * @param first - first position of the range
+ * @param last - position after the last one of the range
+ * @param firstCell - first cell given to the range
+ * @param count - number of cells to split the range into
+ */
+void ArcFlags::partition(const CSRGraph &csr, vector<int> &vertexes, const int first, const int last, const int firstCell, const int count) {
+    if(count == 1 || last - first <= 1) {
+        for(int i = first; i < last; i++) cells[vertexes[i]] = firstCell;
+        return;
+    }
+
+    double minX = numeric_limits<double>::infinity(), maxX = -minX, minY = minX, maxY = -minX;
+    for(int i = first; i < last; i++) {
+        minX = min(minX, csr.xs[vertexes[i]]);
+        maxX = max(maxX, csr.xs[vertexes[i]]);
+        minY = min(minY, csr.ys[vertexes[i]]);
+        maxY = max(maxY, csr.ys[vertexes[i]]);
+    }
+    const vector<double> &coordinates = maxX - minX >= maxY - minY ? csr.xs : csr.ys;
+
+    // an odd number of cells is split with the vertexes in the same proportion as the cells
+    int firstCount = count / 2;
+    int middle = first + (long long) (last - first) * firstCount / count;
+    nth_element(vertexes.begin() + first, vertexes.begin() + middle, vertexes.begin() + last,
+                [&coordinates](const int a, const int b) { return coordinates[a] < coordinates[b]; });
+
+    partition(csr, vertexes, first, middle, firstCell, firstCount);
+    partition(csr, vertexes, middle, last, firstCell + firstCount, count - firstCount);
+}
+
+/**
+ * @brief Dijkstra from a boundary vertex to every vertex, following the arcs in both directions, and then sets the
+ * flag of the cell of the boundary in every arc that is part of a shortest path to it
+ * @param csr - CSR arrays of the graph
+ * @param boundary - index of the boundary vertex
+ * @param dist - scratch array for the distances to the boundary
+ * @param arcFlags - flags of the outgoing arcs, updated
+ * @param invArcFlags - flags of the ingoing arcs, updated
+ */
+void ArcFlags::flagPaths(const CSRGraph &csr, const int boundary, vector<double> &dist, vector<uint64_t> &arcFlags, vector<uint64_t> &invArcFlags) const {
+    int numVertex = cells.size();
+    dist.assign(numVertex, numeric_limits<double>::infinity());
+    priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> queue;
+
+    dist[boundary] = 0;
+    queue.push(make_pair(0, boundary));
+
+    while(!queue.empty()) {
+        double vertexDist = queue.top().first;
+        int vertex = queue.top().second;
+        queue.pop();
+        if(vertexDist > dist[vertex]) continue;
+
+        for(int arc = csr.offsets[vertex]; arc < csr.offsets[vertex + 1]; arc++)
+            if(vertexDist + csr.weights[arc] < dist[csr.targets[arc]]) {
+                dist[csr.targets[arc]] = vertexDist + csr.weights[arc];
+                queue.push(make_pair(dist[csr.targets[arc]], csr.targets[arc]));
+            }
+
+        for(int arc = csr.invOffsets[vertex]; arc < csr.invOffsets[vertex + 1]; arc++)
+            if(vertexDist + csr.invWeights[arc] < dist[csr.invTargets[arc]]) {
+                dist[csr.invTargets[arc]] = vertexDist + csr.invWeights[arc];
+                queue.push(make_pair(dist[csr.invTargets[arc]], csr.invTargets[arc]));
+            }
+    }
+
+    // An arc from a vertex is on a shortest path to the boundary when the path through it is as short as the
+    // distance of the vertex. Every such arc is flagged (not only the ones of the tree), so whatever shortest path
+    // the query follows is flagged too, and the rounding of the sums can only flag more arcs
+    uint64_t flag = (uint64_t) 1 << cells[boundary];
+    for(int vertex = 0; vertex < numVertex; vertex++) {
+        if(dist[vertex] == numeric_limits<double>::infinity()) continue;
+        double tolerance = dist[vertex] * 1e-9;
+
+        for(int arc = csr.offsets[vertex]; arc < csr.offsets[vertex + 1]; arc++)
+            if(dist[csr.targets[arc]] + csr.weights[arc] <= dist[vertex] + tolerance) arcFlags[arc] |= flag;
+
+        for(int arc = csr.invOffsets[vertex]; arc < csr.invOffsets[vertex + 1]; arc++)
+            if(dist[csr.invTargets[arc]] + csr.invWeights[arc] <= dist[vertex] + tolerance) invArcFlags[arc] |= flag;
+    }
+}
+
+/**
+ * @brief Splits the graph into cells and computes the flags of every arc, with the searches from the boundary
+ * vertexes split between the workers of a scheduler
+ * @param csr - CSR arrays of the graph
+ * @param numCells - number of cells (at most maxCells, less if the graph is smaller)
+ * @param scheduler - scheduler that runs the searches
+ */
+void ArcFlags::build(const CSRGraph &csr, const int numCells, TaskScheduler &scheduler) {
+    clear();
+    int numVertex = csr.getNumVertex(), numArcs = csr.getNumArcs();
+    if(numVertex == 0 || numCells <= 0) return;
+    this->numCells = min(numCells, numVertex);
+    if(this->numCells > maxCells) this->numCells = maxCells;
+
+    vector<int> vertexes(numVertex);
+    for(int vertex = 0; vertex < numVertex; vertex++) vertexes[vertex] = vertex;
+    cells.assign(numVertex, 0);
+    partition(csr, vertexes, 0, numVertex, 0, this->numCells);
+
+    // The arcs that end in a cell lead to it, which covers the paths after they enter the cell for the last time
+    flags.assign(numArcs, 0);
+    invFlags.assign(numArcs, 0);
+    vector<int> boundaries;
+    for(int vertex = 0; vertex < numVertex; vertex++) {
+        bool boundary = false;
+        for(int arc = csr.offsets[vertex]; arc < csr.offsets[vertex + 1]; arc++) {
+            flags[arc] |= (uint64_t) 1 << cells[csr.targets[arc]];
+            if(cells[csr.targets[arc]] != cells[vertex]) boundary = true;
+        }
+        for(int arc = csr.invOffsets[vertex]; arc < csr.invOffsets[vertex + 1]; arc++) {
+            invFlags[arc] |= (uint64_t) 1 << cells[csr.invTargets[arc]];
+            if(cells[csr.invTargets[arc]] != cells[vertex]) boundary = true;
+        }
+        if(boundary) boundaries.push_back(vertex);
+    }
+
+    // Each worker sets the flags of its searches in its own arrays, which are merged at the end
+    int numWorkers = scheduler.getNumWorkers();
+    vector<vector<uint64_t>> workerFlags(numWorkers), workerInvFlags(numWorkers);
+    vector<vector<double>> workerDist(numWorkers);
+    scheduler.parallelFor(boundaries.size(), [&](const int item, const int worker) {
+        if(workerFlags[worker].empty()) {
+            workerFlags[worker].assign(numArcs, 0);
+            workerInvFlags[worker].assign(numArcs, 0);
+        }
+        flagPaths(csr, boundaries[item], workerDist[worker], workerFlags[worker], workerInvFlags[worker]);
+    });
+
+    for(int worker = 0; worker < numWorkers; worker++) {
+        if(workerFlags[worker].empty()) continue;
+        for(int arc = 0; arc < numArcs; arc++) {
+            flags[arc] |= workerFlags[worker][arc];
+            invFlags[arc] |= workerInvFlags[worker][arc];
+        }
+    }
+}
+
+void ArcFlags::clear() {
+    cells.clear();
+    flags.clear();
+    invFlags.clear();
+    numCells = 0;
+}
+
+int ArcFlags::getNumCells() const {
+    return numCells;
+}
+
+/**
+ * @param vertex - index of a vertex
+ * @return - the cell of the vertex
+ */
+int ArcFlags::getCell(const int vertex) const {
+    return cells[vertex];
+}
+
+/**
+ * @param arc - outgoing arc of the csr
+ * @param cell - a cell
+ * @return - true if following the arc can be part of a shortest path to a vertex of the cell
+ */
+bool ArcFlags::leadsTo(const int arc, const int cell) const {
+    return (flags[arc] >> cell) & 1;
+}
+
+/**
+ * @param arc - ingoing arc of the csr, followed from its target to its origin
+ * @param cell - a cell
+ * @return - true if following the arc can be part of a shortest path to a vertex of the cell
+ */
+bool ArcFlags::invLeadsTo(const int arc, const int cell) const {
+    return (invFlags[arc] >> cell) & 1;
+}
+
+/**
+ * @return number of bytes used by the cells and the flags
+ */
+size_t ArcFlags::getMemoryUsage() const {
+    return cells.size() * sizeof(int) + (flags.size() + invFlags.size()) * sizeof(uint64_t);
+}
+
+#endif
@@ -0,0 +1,109 @@
+#pragma once
+#ifndef ARENA_H_
+#define ARENA_H_
+
+#include <vector>
+#include <new>
+#include <utility>
+#include <type_traits>
+
+using namespace std;
+
+/**
+ * Owns objects of type T, created in blocks of blockSize objects each.
+ * Creating an object only allocates memory when the current block is full, and the objects never move,
+ * so pointers to them stay valid until the arena is cleared or destroyed. The objects can't be deleted
+ * one by one: all of them are destroyed together by clear() or by the destructor of the arena.
+ */
+template <class T>
+class Arena {
+private:
+    vector<T*> blocks;          // storage of the objects, each block with space for blockSize objects
+    size_t blockSize;
+    size_t used = 0;            // number of objects created in the last block
+
+public:
+    explicit Arena(const size_t blockSize = 1024) : blockSize(blockSize) {}
+    Arena(const Arena &arena) = delete;
+    Arena &operator=(const Arena &arena) = delete;
+    ~Arena();
+
+    template <class... Args>
+    T* create(Args&&... args);
+    void clear();
+    void swap(Arena &arena);
+
+    size_t size() const;
+    size_t getMemoryUsage() const;
+};
+
+template <class T>
+Arena<T>::~Arena() {
+    clear();
+}
+
+/**
+ * @brief Creates a new object in the arena
+ * @param args - arguments given to the constructor of T
+ * @return - a pointer to the object, owned by the arena
+ */
+template <class T>
+template <class... Args>
+T* Arena<T>::create(Args&&... args) {
+    if(blocks.empty() || used == blockSize) {
+        blocks.push_back(static_cast<T*>(::operator new(blockSize * sizeof(T))));
+        used = 0;
+    }
+
+    T *object = new(blocks.back() + used) T(forward<Args>(args)...);
+    used++;
+    return object;
+}
+
+/**
+ * @brief Destroys every object of the arena and releases its memory
+ */
+template <class T>
+void Arena<T>::clear() {
+    for(size_t i = 0; i < blocks.size(); i++) {
+        // only the last block may not be full
+        if(!is_trivially_destructible<T>::value) {
+            size_t count = i + 1 == blocks.size() ? used : blockSize;
+            for(size_t j = 0; j < count; j++)
+                blocks[i][j].~T();
+        }
+        ::operator delete(blocks[i]);
+    }
+
+    blocks.clear();
+    used = 0;
+}
+
+/**
+ * @brief Exchanges the objects of two arenas, without moving them (the pointers to them stay valid)
+ * @param arena - the other arena
+ */
+template <class T>
+void Arena<T>::swap(Arena &arena) {
+    blocks.swap(arena.blocks);
+    std::swap(blockSize, arena.blockSize);
+    std::swap(used, arena.used);
+}
+
+/**
+ * @return - the number of objects in the arena
+ */
+template <class T>
+size_t Arena<T>::size() const {
+    return blocks.empty() ? 0 : (blocks.size() - 1) * blockSize + used;
+}
+
+/**
+ * @return - number of bytes allocated by the arena (not counting the memory owned by the objects)
+ */
+template <class T>
+size_t Arena<T>::getMemoryUsage() const {
+    return blocks.size() * blockSize * sizeof(T);
+}
+
+#endif
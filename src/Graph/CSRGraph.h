@@ -0,0 +1,196 @@
+#pragma once
+#ifndef CSR_GRAPH_H_
+#define CSR_GRAPH_H_
+
+#include <vector>
+#include <cmath>
+#include "Vertex.h"
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+using namespace std;
+
+/**
+ * Compressed sparse row (CSR) representation of the edges of a graph, used by the search algorithms.
+ * The outgoing arcs of the vertex with index i are stored in the positions [offsets[i], offsets[i + 1])
+ * of the targets, weights and edgeIds arrays. The inv arrays store the ingoing arcs in the same way,
+ * so invTargets holds the origin of each arc. Both directions are built from the outgoing adjacency lists.
+ * The coordinates are kept as a structure of arrays, per vertex and per arc (the coordinates of its target), so the
+ * heuristic distances of all the neighbours of a vertex are computed from consecutive memory, two at a time with SSE2.
+ */
+class CSRGraph {
+private:
+    vector<int> offsets;            // first outgoing arc of each vertex (size = numVertex + 1)
+    vector<int> targets;            // index of the destination vertex of each arc
+    vector<double> weights;         // weight of each arc
+    vector<int> edgeIds;            // id of the Edge each arc was built from
+
+    vector<int> invOffsets;         // first ingoing arc of each vertex (size = numVertex + 1)
+    vector<int> invTargets;         // index of the origin vertex of each ingoing arc
+    vector<double> invWeights;
+    vector<int> invEdgeIds;
+    vector<int> invArcs;            // position of each ingoing arc in the outgoing arrays
+
+    vector<double> xs, ys;          // coordinates of each vertex
+    vector<double> targetXs, targetYs;          // coordinates of the target of each arc
+    vector<double> invTargetXs, invTargetYs;    // coordinates of the target of each ingoing arc (its origin)
+
+public:
+    void build(const vector<Vertex*> &vertexSet);
+    void clear();
+
+    int getNumVertex() const;
+    int getNumArcs() const;
+    size_t getMemoryUsage() const;
+
+    inline double distance(const int vertex, const double x, const double y) const;
+    inline void arcDistances(const bool outgoing, const int first, const int last, const double x, const double y, double *distances) const;
+
+    friend class Graph;
+    friend class ContractionHierarchy;
+    friend class Landmarks;
+    friend class ArcFlags;
+    friend class CustomizableContractionHierarchy;
+};
+
+/**
+ * @brief Builds both the forward and the reverse CSR arrays from the adjacency lists of the vertexes
+ * @param vertexSet - vertexes of the graph, each one with its index equal to its position in the vector
+ */
+void CSRGraph::build(const vector<Vertex*> &vertexSet) {
+    int numVertex = vertexSet.size();
+    clear();
+
+    // Count the arcs of each vertex and turn the counts into offsets
+    offsets.resize(numVertex + 1, 0);
+    invOffsets.resize(numVertex + 1, 0);
+    for(int i = 0; i < numVertex; i++) {
+        offsets[i + 1] = offsets[i] + vertexSet[i]->adj.size();
+        for(const Edge &edge : vertexSet[i]->adj)
+            invOffsets[edge.dest->index + 1]++;
+    }
+    for(int i = 0; i < numVertex; i++)
+        invOffsets[i + 1] += invOffsets[i];
+
+    int numArcs = offsets[numVertex];
+    targets.reserve(numArcs);
+    weights.reserve(numArcs);
+    edgeIds.reserve(numArcs);
+    invTargets.resize(numArcs);
+    invWeights.resize(numArcs);
+    invEdgeIds.resize(numArcs);
+    invArcs.resize(numArcs);
+    targetXs.reserve(numArcs);
+    targetYs.reserve(numArcs);
+    invTargetXs.resize(numArcs);
+    invTargetYs.resize(numArcs);
+
+    xs.resize(numVertex);
+    ys.resize(numVertex);
+    for(int i = 0; i < numVertex; i++) {
+        xs[i] = vertexSet[i]->pos.getX();
+        ys[i] = vertexSet[i]->pos.getY();
+    }
+
+    // Next free position of the ingoing arcs of each vertex
+    vector<int> nextInvArc(invOffsets.begin(), invOffsets.end() - 1);
+
+    // The arcs are stored in the same order as the adjacency lists, one vertex after the other
+    for(Vertex *vertex : vertexSet) {
+        for(const Edge &edge : vertex->adj) {
+            int invArc = nextInvArc[edge.dest->index]++;
+            invTargets[invArc] = vertex->index;
+            invWeights[invArc] = edge.weight;
+            invEdgeIds[invArc] = edge.id;
+            invArcs[invArc] = targets.size();
+            invTargetXs[invArc] = xs[vertex->index];
+            invTargetYs[invArc] = ys[vertex->index];
+
+            targets.push_back(edge.dest->index);
+            weights.push_back(edge.weight);
+            edgeIds.push_back(edge.id);
+            targetXs.push_back(xs[edge.dest->index]);
+            targetYs.push_back(ys[edge.dest->index]);
+        }
+    }
+}
+
+void CSRGraph::clear() {
+    offsets.clear();
+    targets.clear();
+    weights.clear();
+    edgeIds.clear();
+    invOffsets.clear();
+    invTargets.clear();
+    invWeights.clear();
+    invEdgeIds.clear();
+    invArcs.clear();
+    xs.clear();
+    ys.clear();
+    targetXs.clear();
+    targetYs.clear();
+    invTargetXs.clear();
+    invTargetYs.clear();
+}
+
+int CSRGraph::getNumVertex() const {
+    return offsets.empty() ? 0 : offsets.size() - 1;
+}
+
+int CSRGraph::getNumArcs() const {
+    return targets.size();
+}
+
+/**
+ * @return number of bytes used by the CSR arrays
+ */
+size_t CSRGraph::getMemoryUsage() const {
+    return (offsets.size() + targets.size() + edgeIds.size() + invOffsets.size() + invTargets.size() + invEdgeIds.size() + invArcs.size()) * sizeof(int)
+           + (weights.size() + invWeights.size() + xs.size() + ys.size() + targetXs.size() + targetYs.size()
+              + invTargetXs.size() + invTargetYs.size()) * sizeof(double);
+}
+
+/**
+ * @param vertex - index of a vertex
+ * @param x - x coordinate of a point
+ * @param y - y coordinate of a point
+ * @return - the euclidean distance between the vertex and the point
+ */
+double CSRGraph::distance(const int vertex, const double x, const double y) const {
+    double dx = x - xs[vertex], dy = y - ys[vertex];
+    return sqrt(dx * dx + dy * dy);
+}
+
+/**
+ * @brief Computes the euclidean distance between a point and the target of each arc of a range, two arcs at a time
+ * when SSE2 is available. The results are the same as the ones of distance
+ * @param outgoing - true for a range of outgoing arcs, false for a range of ingoing arcs
+ * @param first - first arc of the range
+ * @param last - arc after the last one of the range
+ * @param x - x coordinate of the point
+ * @param y - y coordinate of the point
+ * @param distances - filled with the distance of each arc, distances[arc - first]
+ */
+void CSRGraph::arcDistances(const bool outgoing, const int first, const int last, const double x, const double y, double *distances) const {
+    const double *arcXs = outgoing ? targetXs.data() : invTargetXs.data();
+    const double *arcYs = outgoing ? targetYs.data() : invTargetYs.data();
+    int arc = first;
+
+#ifdef __SSE2__
+    __m128d pointX = _mm_set1_pd(x), pointY = _mm_set1_pd(y);
+    for(; arc + 2 <= last; arc += 2) {
+        __m128d dx = _mm_sub_pd(pointX, _mm_loadu_pd(arcXs + arc));
+        __m128d dy = _mm_sub_pd(pointY, _mm_loadu_pd(arcYs + arc));
+        _mm_storeu_pd(distances + arc - first, _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(dx, dx), _mm_mul_pd(dy, dy))));
+    }
+#endif
+
+    for(; arc < last; arc++) {
+        double dx = x - arcXs[arc], dy = y - arcYs[arc];
+        distances[arc - first] = sqrt(dx * dx + dy * dy);
+    }
+}
+
+#endif
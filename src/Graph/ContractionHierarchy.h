@@ -0,0 +1,428 @@
+#pragma once
+#ifndef CONTRACTION_HIERARCHY_H_
+#define CONTRACTION_HIERARCHY_H_
+
+#include <vector>
+#include <queue>
+#include <functional>
+#include <unordered_set>
+#include <algorithm>
+#include "CSRGraph.h"
+#include "SearchContext.h"
+#include "MutablePriorityQueue.h"
+
+using namespace std;
+
+/**
+ * Contraction hierarchy of the graph, built from its CSR arrays.
+ * The vertexes are contracted one at a time, from the least important to the most important one: when a vertex is
+ * contracted, a shortcut is added between each pair of its neighbours whose shortest path goes through it.
+ * A query is then a bidirectional dijkstra that only follows arcs to vertexes contracted later (upward arcs),
+ * and the shortcuts of the resulting path are unpacked back into arcs of the CSR.
+ * Like the other searches, the edges are followed in both directions, so every arc (and shortcut) works both ways.
+ */
+class ContractionHierarchy {
+    friend class HubLabels;
+    friend class DistanceTable;
+
+private:
+    struct Arc {
+        int from, to;               // index of the vertexes connected by the arc
+        double weight;
+        int middle;                 // vertex contracted to create the shortcut (-1 if it is an arc of the graph)
+        int first, second;          // arcs replaced by the shortcut (between middle and from, and middle and to)
+        int csrArc;                 // position of the arc in the outgoing csr arrays (-1 if it is a shortcut)
+        int edgeId;                 // id of the Edge the arc was built from (-1 if it is a shortcut)
+    };
+
+    vector<Arc> arcs;               // arcs of the graph and shortcuts
+    vector<int> rank;               // order in which each vertex was contracted
+    int numShortcuts = 0;
+
+    vector<int> upOffsets;          // arcs of each vertex to vertexes with a higher rank (size = numVertex + 1)
+    vector<int> upTargets;
+    vector<double> upWeights;
+    vector<int> upArcs;             // position of each upward arc in the arcs vector
+
+    // contraction
+    vector<vector<int>> graphArcs;  // arcs of each vertex that connect it to vertexes not contracted yet
+    vector<double> witnessDist;     // distances of the witness search, valid when the stamp is the current generation
+    vector<unsigned> witnessStamp;
+    unsigned witnessGeneration = 0;
+    const static int maxSettled = 500;
+
+    int otherEnd(const int arc, const int vertex) const;
+    void witnessSearch(const int source, const int contracted, const double maxDist);
+    double getWitnessDist(const int vertex) const;
+    int contractVertex(const int vertex, const bool simulate);
+    void unpack(const int arc, const int from, vector<int> &pathVertexes, vector<int> &pathArcs) const;
+
+public:
+    void build(const CSRGraph &csr);
+    void clear();
+    bool query(SearchContext &context, const int start, const int final, vector<int> &pathVertexes, vector<int> &pathArcs, unordered_set<int> &processedEdges) const;
+    void upwardSearch(SearchContext &context, const int source, vector<int> &settled) const;
+
+    int getNumShortcuts() const;
+    size_t getMemoryUsage() const;
+};
+
+/**
+ * @param arc - index of the arc
+ * @param vertex - one of the ends of the arc
+ * @return - the index of the other end of the arc
+ */
+int ContractionHierarchy::otherEnd(const int arc, const int vertex) const {
+    return arcs[arc].from == vertex ? arcs[arc].to : arcs[arc].from;
+}
+
+/**
+ * @brief Dijkstra from the source over the vertexes not contracted yet, without going through the vertex
+ * being contracted. Stops after settling maxSettled vertexes or when the distance goes over maxDist,
+ * so a missing witness can only add an unnecessary shortcut, never lose a path
+ * @param source - index of the vertex where the search starts
+ * @param contracted - index of the vertex being contracted
+ * @param maxDist - length of the longest shortcut that the search has to check
+ */
+void ContractionHierarchy::witnessSearch(const int source, const int contracted, const double maxDist) {
+    witnessGeneration++;
+    priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> queue;
+
+    witnessStamp[source] = witnessGeneration;
+    witnessDist[source] = 0;
+    queue.push(make_pair(0, source));
+
+    int settled = 0;
+    while(!queue.empty() && settled < maxSettled) {
+        double dist = queue.top().first;
+        int vertex = queue.top().second;
+        queue.pop();
+
+        // the vertex was already settled with a smaller distance
+        if(dist > witnessDist[vertex]) continue;
+        if(dist > maxDist) break;
+        settled++;
+
+        for(int arc : graphArcs[vertex]) {
+            int next = otherEnd(arc, vertex);
+            if(next == contracted) continue;
+
+            double newDist = dist + arcs[arc].weight;
+            if(witnessStamp[next] != witnessGeneration || newDist < witnessDist[next]) {
+                witnessStamp[next] = witnessGeneration;
+                witnessDist[next] = newDist;
+                queue.push(make_pair(newDist, next));
+            }
+        }
+    }
+}
+
+/**
+ * @return - the distance found by the last witness search to the vertex (infinite if it wasn't reached)
+ */
+double ContractionHierarchy::getWitnessDist(const int vertex) const {
+    return witnessStamp[vertex] == witnessGeneration ? witnessDist[vertex] : numeric_limits<double>::infinity();
+}
+
+/**
+ * @brief Finds the shortcuts needed to contract a vertex, adding them if it isn't a simulation
+ * @param vertex - index of the vertex to contract
+ * @param simulate - if true, the shortcuts are only counted (used to choose the order of the contraction)
+ * @return - the number of shortcuts needed
+ */
+int ContractionHierarchy::contractVertex(const int vertex, const bool simulate) {
+    int shortcuts = 0;
+    const vector<int> &neighbourArcs = graphArcs[vertex];
+
+    // every pair of neighbours is checked once, since the arcs work in both directions
+    for(size_t i = 0; i + 1 < neighbourArcs.size(); i++) {
+        int firstArc = neighbourArcs[i];
+        int first = otherEnd(firstArc, vertex);
+        double firstWeight = arcs[firstArc].weight;
+
+        double maxDist = 0;
+        for(size_t j = i + 1; j < neighbourArcs.size(); j++)
+            maxDist = max(maxDist, firstWeight + arcs[neighbourArcs[j]].weight);
+        witnessSearch(first, vertex, maxDist);
+
+        for(size_t j = i + 1; j < neighbourArcs.size(); j++) {
+            int secondArc = neighbourArcs[j];
+            int second = otherEnd(secondArc, vertex);
+            double length = firstWeight + arcs[secondArc].weight;
+
+            // there is a path as short as the one through the vertex, so no shortcut is needed
+            if(second == first || getWitnessDist(second) <= length) continue;
+            shortcuts++;
+            if(simulate) continue;
+
+            Arc shortcut = {first, second, length, vertex, firstArc, secondArc, -1, -1};
+            arcs.push_back(shortcut);
+            graphArcs[first].push_back(arcs.size() - 1);
+            graphArcs[second].push_back(arcs.size() - 1);
+
+            // the shortcut may be a witness for the next pairs
+            witnessStamp[second] = witnessGeneration;
+            witnessDist[second] = length;
+        }
+    }
+
+    return shortcuts;
+}
+
+/**
+ * @brief Contracts every vertex of the graph and builds the upward arcs used by the queries.
+ * The next vertex to contract is the one with the smallest edge difference (shortcuts added minus arcs removed)
+ * plus the number of neighbours already contracted, recomputed lazily when it leaves the queue
+ * @param csr - CSR arrays of the graph
+ */
+void ContractionHierarchy::build(const CSRGraph &csr) {
+    int numVertex = csr.getNumVertex();
+    clear();
+
+    graphArcs.assign(numVertex, vector<int>());
+    witnessDist.assign(numVertex, 0);
+    witnessStamp.assign(numVertex, 0);
+    witnessGeneration = 0;
+
+    for(int vertex = 0; vertex < numVertex; vertex++)
+        for(int arc = csr.offsets[vertex]; arc < csr.offsets[vertex + 1]; arc++) {
+            if(csr.targets[arc] == vertex) continue;
+            Arc graphArc = {vertex, csr.targets[arc], csr.weights[arc], -1, -1, -1, arc, csr.edgeIds[arc]};
+            arcs.push_back(graphArc);
+            graphArcs[vertex].push_back(arcs.size() - 1);
+            graphArcs[csr.targets[arc]].push_back(arcs.size() - 1);
+        }
+
+    vector<int> contractedNeighbours(numVertex, 0);
+    vector<bool> contracted(numVertex, false);
+    rank.assign(numVertex, -1);
+
+    auto priority = [&](const int vertex) {
+        return contractVertex(vertex, true) - (int) graphArcs[vertex].size() + contractedNeighbours[vertex];
+    };
+
+    priority_queue<pair<int, int>, vector<pair<int, int>>, greater<pair<int, int>>> queue;
+    for(int vertex = 0; vertex < numVertex; vertex++)
+        queue.push(make_pair(priority(vertex), vertex));
+
+    int nextRank = 0;
+    while(!queue.empty()) {
+        int vertex = queue.top().second;
+        queue.pop();
+        if(contracted[vertex]) continue;
+
+        // the priority may have changed since it was inserted, in that case it goes back to the queue
+        int current = priority(vertex);
+        if(!queue.empty() && current > queue.top().first) {
+            queue.push(make_pair(current, vertex));
+            continue;
+        }
+
+        numShortcuts += contractVertex(vertex, false);
+        contracted[vertex] = true;
+        rank[vertex] = nextRank++;
+
+        // the arcs of the vertex now only lead to vertexes with a higher rank, so they are removed from the neighbours
+        for(int arc : graphArcs[vertex]) {
+            int neighbour = otherEnd(arc, vertex);
+            contractedNeighbours[neighbour]++;
+            vector<int> &neighbourArcs = graphArcs[neighbour];
+            neighbourArcs.erase(remove_if(neighbourArcs.begin(), neighbourArcs.end(), [&](const int a) {
+                return otherEnd(a, neighbour) == vertex;
+            }), neighbourArcs.end());
+        }
+    }
+
+    // the arcs left in each vertex when it was contracted are its upward arcs
+    upOffsets.assign(numVertex + 1, 0);
+    for(int vertex = 0; vertex < numVertex; vertex++)
+        upOffsets[vertex + 1] = upOffsets[vertex] + graphArcs[vertex].size();
+    for(int vertex = 0; vertex < numVertex; vertex++)
+        for(int arc : graphArcs[vertex]) {
+            upTargets.push_back(otherEnd(arc, vertex));
+            upWeights.push_back(arcs[arc].weight);
+            upArcs.push_back(arc);
+        }
+
+    // the contraction state is not needed by the queries
+    vector<vector<int>>().swap(graphArcs);
+    vector<double>().swap(witnessDist);
+    vector<unsigned>().swap(witnessStamp);
+}
+
+void ContractionHierarchy::clear() {
+    arcs.clear();
+    rank.clear();
+    upOffsets.clear();
+    upTargets.clear();
+    upWeights.clear();
+    upArcs.clear();
+    numShortcuts = 0;
+}
+
+/**
+ * @brief Adds the vertexes and csr arcs of an arc to the path, replacing the shortcuts by the arcs they represent
+ * @param arc - index of the arc
+ * @param from - index of the end of the arc where the path comes from
+ * @param pathVertexes - vertexes of the path, the other end of the arc is added to it
+ * @param pathArcs - csr arcs of the path
+ */
+void ContractionHierarchy::unpack(const int arc, const int from, vector<int> &pathVertexes, vector<int> &pathArcs) const {
+    const Arc &current = arcs[arc];
+    if(current.middle == -1) {
+        pathArcs.push_back(current.csrArc);
+        pathVertexes.push_back(otherEnd(arc, from));
+        return;
+    }
+
+    // the shortcut goes from -> middle -> other end
+    int firstHalf = otherEnd(current.first, current.middle) == from ? current.first : current.second;
+    int secondHalf = firstHalf == current.first ? current.second : current.first;
+    unpack(firstHalf, from, pathVertexes, pathArcs);
+    unpack(secondHalf, current.middle, pathVertexes, pathArcs);
+}
+
+/**
+ * @brief Finds the shortest path between two vertexes with a bidirectional search over the upward arcs.
+ * Each direction stops when its next vertex is farther than the best path found
+ * @param context - search context where the searches are saved
+ * @param start - index of the vertex where the path starts
+ * @param final - index of the vertex where the path ends
+ * @param pathVertexes - filled with the vertexes of the path, from start to final
+ * @param pathArcs - filled with the csr arcs of the path (pathArcs[i] connects pathVertexes[i] and pathVertexes[i + 1])
+ * @param processedEdges - set that stores the id of the edges of the graph that are processed
+ * @return - true if there is a path
+ */
+bool ContractionHierarchy::query(SearchContext &context, const int start, const int final, vector<int> &pathVertexes, vector<int> &pathArcs, unordered_set<int> &processedEdges) const {
+    pathVertexes.clear();
+    pathArcs.clear();
+
+    MutablePriorityQueue<double> forwardQueue(context.dist, context.queueIndex);
+    MutablePriorityQueue<double> backwardQueue(context.invDist, context.invQueueIndex);
+    forwardQueue.insert(start);
+    backwardQueue.insert(final);
+
+    double best = numeric_limits<double>::infinity();
+    int middle = start == final ? start : -1;
+    if(middle != -1) best = 0;
+
+    bool forwardDone = false, backwardDone = false;
+    while(!forwardDone || !backwardDone) {
+        for(int direction = 0; direction < 2; direction++) {
+            bool forward = direction == 0;
+            bool &done = forward ? forwardDone : backwardDone;
+            MutablePriorityQueue<double> &queue = forward ? forwardQueue : backwardQueue;
+            if(done) continue;
+            if(queue.empty()) {
+                done = true;
+                continue;
+            }
+
+            vector<double> &dist = forward ? context.dist : context.invDist;
+            vector<double> &otherDist = forward ? context.invDist : context.dist;
+            vector<int> &path = forward ? context.path : context.invPath;
+            vector<int> &edgePath = forward ? context.edgePath : context.invEdgePath;
+            vector<int> &queueIndex = forward ? context.queueIndex : context.invQueueIndex;
+
+            int vertex = queue.extractMin();
+
+            // no vertex left in this direction can improve the best path
+            if(dist[vertex] >= best) {
+                done = true;
+                continue;
+            }
+
+            for(int arc = upOffsets[vertex]; arc < upOffsets[vertex + 1]; arc++) {
+                int next = upTargets[arc];
+                double newDist = dist[vertex] + upWeights[arc];
+                context.touch(next);
+
+                // Save the edge that has been processed to be drawn later (shortcuts aren't edges of the graph)
+                if(arcs[upArcs[arc]].edgeId != -1)
+                    processedEdges.insert(arcs[upArcs[arc]].edgeId);
+
+                if(newDist < dist[next]) {
+                    dist[next] = newDist;
+                    path[next] = vertex;
+                    edgePath[next] = upArcs[arc];
+                    if(queueIndex[next] == 0) queue.insert(next);
+                    else queue.decreaseKey(next);
+                }
+
+                // both searches reached the vertex, so there is a path through it
+                if(otherDist[next] != SearchContext::infinite && dist[next] + otherDist[next] < best) {
+                    best = dist[next] + otherDist[next];
+                    middle = next;
+                }
+            }
+        }
+    }
+
+    if(middle == -1) return false;
+
+    // forward half, from the middle back to the start
+    vector<int> forwardArcs;
+    for(int vertex = middle; vertex != start; vertex = context.path[vertex])
+        forwardArcs.push_back(context.edgePath[vertex]);
+    reverse(forwardArcs.begin(), forwardArcs.end());
+
+    pathVertexes.push_back(start);
+    for(int arc : forwardArcs)
+        unpack(arc, pathVertexes.back(), pathVertexes, pathArcs);
+
+    // backward half, from the middle to the final vertex
+    for(int vertex = middle; vertex != final; vertex = context.invPath[vertex])
+        unpack(context.invEdgePath[vertex], vertex, pathVertexes, pathArcs);
+
+    return true;
+}
+
+/**
+ * @brief Dijkstra from a vertex that only follows the upward arcs, until the queue is empty (the upward search space
+ * is small, so no stopping rule is needed). The arc used to reach each vertex is saved in the edgePath of the context
+ * @param context - search context where the search is saved
+ * @param source - index of the vertex where the search starts
+ * @param settled - filled with the vertexes settled by the search, in the order they were settled
+ */
+void ContractionHierarchy::upwardSearch(SearchContext &context, const int source, vector<int> &settled) const {
+    settled.clear();
+    context.newSearch(rank.size());
+    context.touch(source);
+    context.dist[source] = 0;
+
+    MutablePriorityQueue<double> queue(context.dist, context.queueIndex);
+    queue.insert(source);
+
+    while(!queue.empty()) {
+        int vertex = queue.extractMin();
+        settled.push_back(vertex);
+
+        for(int arc = upOffsets[vertex]; arc < upOffsets[vertex + 1]; arc++) {
+            int next = upTargets[arc];
+            double newDist = context.dist[vertex] + upWeights[arc];
+            context.touch(next);
+
+            if(newDist < context.dist[next]) {
+                context.dist[next] = newDist;
+                context.path[next] = vertex;
+                context.edgePath[next] = upArcs[arc];
+                if(context.queueIndex[next] == 0) queue.insert(next);
+                else queue.decreaseKey(next);
+            }
+        }
+    }
+}
+
+int ContractionHierarchy::getNumShortcuts() const {
+    return numShortcuts;
+}
+
+/**
+ * @return number of bytes used by the arcs and the upward arrays
+ */
+size_t ContractionHierarchy::getMemoryUsage() const {
+    return arcs.size() * sizeof(Arc) + (rank.size() + upOffsets.size() + upTargets.size() + upArcs.size()) * sizeof(int)
+           + upWeights.size() * sizeof(double);
+}
+
+#endif
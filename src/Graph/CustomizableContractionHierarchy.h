@@ -0,0 +1,402 @@
+#pragma once
+#ifndef CUSTOMIZABLE_CONTRACTION_HIERARCHY_H_
+#define CUSTOMIZABLE_CONTRACTION_HIERARCHY_H_
+
+#include <vector>
+#include <unordered_set>
+#include <algorithm>
+#include <limits>
+#include "CSRGraph.h"
+#include "SearchContext.h"
+
+using namespace std;
+
+/**
+ * Customizable contraction hierarchy (CCH): a contraction hierarchy whose order and arcs don't depend on the weights,
+ * so the weights can change without building it again.
+ * The vertexes are ordered by nested dissection: the graph is split in two halves by position, the vertexes of one
+ * half that touch the other half (the separator) get the highest ranks, and each half is ordered the same way.
+ * Contracting the vertexes in that order, with a shortcut between every pair of neighbours (no witness searches),
+ * gives the arcs of the hierarchy. The lowest ranked upper neighbour of each vertex is its parent in the elimination
+ * tree, and every upper neighbour of a vertex is one of its ancestors.
+ * The customization then sets the weight of each arc from the weights of the graph and the lower triangles
+ * (middle -> from, middle -> to), going up the ranks, and a query only looks at the ancestors of both ends.
+ * Like the other searches, the edges are followed in both directions, so every arc works both ways.
+ */
+class CustomizableContractionHierarchy {
+private:
+    vector<int> rank;               // position of each vertex in the nested dissection order
+    vector<int> order;              // vertex with each rank
+    vector<int> parent;             // parent of each vertex in the elimination tree (-1 in the roots)
+
+    // arcs, independent of the weights
+    vector<int> upOffsets;          // arcs of each vertex to vertexes with a higher rank, by vertex (size = numVertex + 1)
+    vector<int> upSources;          // index of the lower end of each arc
+    vector<int> upTargets;          // index of the upper end of each arc
+    vector<int> csrArcs;            // arc of the hierarchy of each outgoing csr arc (-1 for the loops)
+
+    // weights, set by customize
+    vector<double> upWeights;
+    vector<int> upCsrArcs;          // csr arc with the weight of each arc (-1 if there is none)
+    vector<int> upEdgeIds;          // id of the Edge of that csr arc (-1 if the weight comes from a lower triangle)
+    vector<int> firstHalf;          // arcs of the lower triangle that gives the weight of each arc, between the middle
+    vector<int> secondHalf;         // and the lower end and the middle and the upper end (-1 if it is an arc of the graph)
+    bool customized = false;
+
+    void dissect(const CSRGraph &csr, vector<int> &vertexes, const int first, const int last, vector<int> &side, int &nextSide, int &nextRank);
+    void unpack(const int arc, const int from, vector<int> &pathVertexes, vector<int> &pathArcs) const;
+
+public:
+    void build(const CSRGraph &csr);
+    void customize(const CSRGraph &csr);
+    void clear();
+    bool query(SearchContext &context, const int start, const int final, vector<int> &pathVertexes, vector<int> &pathArcs, unordered_set<int> &processedEdges) const;
+
+    bool isCustomized() const;
+    int getNumArcs() const;
+    int getHeight() const;
+    size_t getMemoryUsage() const;
+};
+
+/**
+ * @brief Orders the vertexes of a range by nested dissection, giving the highest ranks left to its separator
+ * @param csr - CSR arrays of the graph, with the coordinates of the vertexes
+ * @param vertexes - indexes of the vertexes, reordered as the range is split
+ * @param first - first position of the range
+ * @param last - position after the last one of the range
+ * @param side - scratch array with the half each vertex was last put in
+ * @param nextSide - next free half number
+ * @param nextRank - highest rank not given yet, decreased for each vertex
+ */
+void CustomizableContractionHierarchy::dissect(const CSRGraph &csr, vector<int> &vertexes, const int first, const int last, vector<int> &side, int &nextSide, int &nextRank) {
+    if(last - first <= 2) {
+        for(int i = first; i < last; i++) rank[vertexes[i]] = nextRank--;
+        return;
+    }
+
+    // the halves are split across the longest side of the rectangle around the vertexes
+    double minX = numeric_limits<double>::infinity(), maxX = -minX, minY = minX, maxY = -minX;
+    for(int i = first; i < last; i++) {
+        minX = min(minX, csr.xs[vertexes[i]]);
+        maxX = max(maxX, csr.xs[vertexes[i]]);
+        minY = min(minY, csr.ys[vertexes[i]]);
+        maxY = max(maxY, csr.ys[vertexes[i]]);
+    }
+    const vector<double> &coordinates = maxX - minX >= maxY - minY ? csr.xs : csr.ys;
+
+    int middle = first + (last - first) / 2;
+    nth_element(vertexes.begin() + first, vertexes.begin() + middle, vertexes.begin() + last,
+                [&coordinates](const int a, const int b) { return coordinates[a] < coordinates[b]; });
+
+    int sides[2] = {nextSide++, nextSide++};
+    for(int i = first; i < last; i++) side[vertexes[i]] = sides[i < middle ? 0 : 1];
+
+    auto touches = [&](const int vertex, const int otherSide) {
+        for(int arc = csr.offsets[vertex]; arc < csr.offsets[vertex + 1]; arc++)
+            if(side[csr.targets[arc]] == otherSide) return true;
+        for(int arc = csr.invOffsets[vertex]; arc < csr.invOffsets[vertex + 1]; arc++)
+            if(side[csr.invTargets[arc]] == otherSide) return true;
+        return false;
+    };
+
+    // the separator is the smallest of the two sets of vertexes that touch the other half
+    int separatorSize[2] = {0, 0};
+    for(int i = first; i < last; i++)
+        if(touches(vertexes[i], sides[i < middle ? 1 : 0])) separatorSize[i < middle ? 0 : 1]++;
+    int half = separatorSize[0] <= separatorSize[1] ? 0 : 1;
+
+    // the separator is moved to the end of its half
+    int halfFirst = half == 0 ? first : middle, halfLast = half == 0 ? middle : last;
+    int separator = partition(vertexes.begin() + halfFirst, vertexes.begin() + halfLast, [&](const int vertex) {
+        return !touches(vertex, sides[1 - half]);
+    }) - vertexes.begin();
+    for(int i = separator; i < halfLast; i++) rank[vertexes[i]] = nextRank--;
+
+    if(half == 0) {
+        dissect(csr, vertexes, first, separator, side, nextSide, nextRank);
+        dissect(csr, vertexes, middle, last, side, nextSide, nextRank);
+    }
+    else {
+        dissect(csr, vertexes, first, middle, side, nextSide, nextRank);
+        dissect(csr, vertexes, middle, separator, side, nextSide, nextRank);
+    }
+}
+
+/**
+ * @brief Orders the vertexes by nested dissection and contracts them, which gives the arcs of the hierarchy.
+ * The weights are only set by customize
+ * @param csr - CSR arrays of the graph
+ */
+void CustomizableContractionHierarchy::build(const CSRGraph &csr) {
+    int numVertex = csr.getNumVertex();
+    clear();
+
+    rank.assign(numVertex, 0);
+    vector<int> vertexes(numVertex), side(numVertex, -1);
+    for(int vertex = 0; vertex < numVertex; vertex++) vertexes[vertex] = vertex;
+    int nextSide = 0, nextRank = numVertex - 1;
+    dissect(csr, vertexes, 0, numVertex, side, nextSide, nextRank);
+
+    order.assign(numVertex, 0);
+    for(int vertex = 0; vertex < numVertex; vertex++) order[rank[vertex]] = vertex;
+
+    // Contraction: the upper neighbours of each vertex become neighbours of its lowest ranked upper neighbour
+    // (its parent), which is contracted later, so they end up connected to each other
+    vector<vector<int>> upper(numVertex);
+    for(int vertex = 0; vertex < numVertex; vertex++)
+        for(int arc = csr.offsets[vertex]; arc < csr.offsets[vertex + 1]; arc++) {
+            int target = csr.targets[arc];
+            if(target == vertex) continue;
+            if(rank[vertex] < rank[target]) upper[vertex].push_back(target);
+            else upper[target].push_back(vertex);
+        }
+
+    auto byRank = [this](const int a, const int b) { return rank[a] < rank[b]; };
+    parent.assign(numVertex, -1);
+    for(int vertex : order) {
+        vector<int> &neighbours = upper[vertex];
+        sort(neighbours.begin(), neighbours.end(), byRank);
+        neighbours.erase(unique(neighbours.begin(), neighbours.end()), neighbours.end());
+        if(neighbours.empty()) continue;
+
+        parent[vertex] = neighbours[0];
+        vector<int> &parentNeighbours = upper[neighbours[0]];
+        parentNeighbours.insert(parentNeighbours.end(), neighbours.begin() + 1, neighbours.end());
+    }
+
+    upOffsets.assign(numVertex + 1, 0);
+    for(int vertex = 0; vertex < numVertex; vertex++)
+        upOffsets[vertex + 1] = upOffsets[vertex] + upper[vertex].size();
+    upSources.reserve(upOffsets[numVertex]);
+    upTargets.reserve(upOffsets[numVertex]);
+    for(int vertex = 0; vertex < numVertex; vertex++) {
+        for(int neighbour : upper[vertex]) {
+            upSources.push_back(vertex);
+            upTargets.push_back(neighbour);
+        }
+        vector<int>().swap(upper[vertex]);
+    }
+
+    // each csr arc is an arc of the hierarchy from its lower end, found by the rank of the upper end
+    csrArcs.assign(csr.getNumArcs(), -1);
+    for(int vertex = 0; vertex < numVertex; vertex++)
+        for(int arc = csr.offsets[vertex]; arc < csr.offsets[vertex + 1]; arc++) {
+            int target = csr.targets[arc];
+            if(target == vertex) continue;
+            int lower = rank[vertex] < rank[target] ? vertex : target, higher = lower == vertex ? target : vertex;
+            csrArcs[arc] = lower_bound(upTargets.begin() + upOffsets[lower], upTargets.begin() + upOffsets[lower + 1], higher, byRank) - upTargets.begin();
+        }
+}
+
+/**
+ * @brief Sets the weights of the arcs from the current weights of the csr: each arc starts with the smallest
+ * weight of the csr arcs between its ends, and then, going up the ranks, every lower triangle middle -> from -> to
+ * lowers it to the sum of its two arcs if that is shorter. The arcs of a triangle are lower than the arc they
+ * update, so they already have their final weight
+ * @param csr - CSR arrays of the graph the hierarchy was built from, with the new weights
+ */
+void CustomizableContractionHierarchy::customize(const CSRGraph &csr) {
+    int numArcs = upTargets.size();
+    upWeights.assign(numArcs, numeric_limits<double>::infinity());
+    upCsrArcs.assign(numArcs, -1);
+    upEdgeIds.assign(numArcs, -1);
+    firstHalf.assign(numArcs, -1);
+    secondHalf.assign(numArcs, -1);
+
+    for(int arc = 0; arc < csr.getNumArcs(); arc++) {
+        int upArc = csrArcs[arc];
+        if(upArc != -1 && csr.weights[arc] < upWeights[upArc]) {
+            upWeights[upArc] = csr.weights[arc];
+            upCsrArcs[upArc] = arc;
+        }
+    }
+
+    // arcToUpper[w] is the arc between the current vertex and w, if w is one of its upper neighbours
+    vector<int> arcToUpper(rank.size(), -1);
+    for(int middle : order) {
+        int first = upOffsets[middle], last = upOffsets[middle + 1];
+        for(int arc = first; arc < last; arc++) arcToUpper[upTargets[arc]] = arc;
+
+        for(int arc = first; arc < last; arc++) {
+            if(upWeights[arc] == numeric_limits<double>::infinity()) continue;
+            int from = upTargets[arc];
+            for(int upArc = upOffsets[from]; upArc < upOffsets[from + 1]; upArc++) {
+                int other = arcToUpper[upTargets[upArc]];
+                if(other == -1) continue;
+
+                double weight = upWeights[arc] + upWeights[other];
+                if(weight < upWeights[upArc]) {
+                    upWeights[upArc] = weight;
+                    firstHalf[upArc] = arc;
+                    secondHalf[upArc] = other;
+                }
+            }
+        }
+
+        for(int arc = first; arc < last; arc++) arcToUpper[upTargets[arc]] = -1;
+    }
+
+    for(int arc = 0; arc < numArcs; arc++)
+        if(firstHalf[arc] == -1 && upCsrArcs[arc] != -1) upEdgeIds[arc] = csr.edgeIds[upCsrArcs[arc]];
+    customized = true;
+}
+
+void CustomizableContractionHierarchy::clear() {
+    rank.clear();
+    order.clear();
+    parent.clear();
+    upOffsets.clear();
+    upSources.clear();
+    upTargets.clear();
+    csrArcs.clear();
+    upWeights.clear();
+    upCsrArcs.clear();
+    upEdgeIds.clear();
+    firstHalf.clear();
+    secondHalf.clear();
+    customized = false;
+}
+
+/**
+ * @brief Adds the vertexes and csr arcs of an arc to the path, replacing the arcs that got their weight from a lower
+ * triangle by the two arcs of the triangle
+ * @param arc - index of the arc
+ * @param from - index of the end of the arc where the path comes from
+ * @param pathVertexes - vertexes of the path, the other end of the arc is added to it
+ * @param pathArcs - csr arcs of the path
+ */
+void CustomizableContractionHierarchy::unpack(const int arc, const int from, vector<int> &pathVertexes, vector<int> &pathArcs) const {
+    if(firstHalf[arc] == -1) {
+        pathArcs.push_back(upCsrArcs[arc]);
+        pathVertexes.push_back(from == upSources[arc] ? upTargets[arc] : upSources[arc]);
+        return;
+    }
+
+    // the arc goes from -> middle -> other end, the first half being the one between the middle and the lower end
+    int middle = upSources[firstHalf[arc]];
+    bool fromLower = from == upSources[arc];
+    unpack(fromLower ? firstHalf[arc] : secondHalf[arc], from, pathVertexes, pathArcs);
+    unpack(fromLower ? secondHalf[arc] : firstHalf[arc], middle, pathVertexes, pathArcs);
+}
+
+/**
+ * @brief Finds the shortest path between two vertexes. Every vertex the upward arcs reach from a vertex is one of
+ * its ancestors in the elimination tree, so each direction relaxes the upward arcs of the ancestors of its end,
+ * without a queue. Both directions go up at the same time, by rank, so their distances in a common ancestor are final
+ * when they get there, and the path goes through the common ancestor where the sum is the smallest. From then on,
+ * ancestors already as far as the best path don't relax their arcs (the highest ones have the most arcs)
+ * @param context - search context where the searches are saved, with the distances of both ends already set to 0
+ * @param start - index of the vertex where the path starts
+ * @param final - index of the vertex where the path ends
+ * @param pathVertexes - filled with the vertexes of the path, from start to final
+ * @param pathArcs - filled with the csr arcs of the path (pathArcs[i] connects pathVertexes[i] and pathVertexes[i + 1])
+ * @param processedEdges - set that stores the id of the edges of the graph that are processed
+ * @return - true if there is a path
+ */
+bool CustomizableContractionHierarchy::query(SearchContext &context, const int start, const int final, vector<int> &pathVertexes, vector<int> &pathArcs, unordered_set<int> &processedEdges) const {
+    pathVertexes.clear();
+    pathArcs.clear();
+    if(!customized) return false;
+
+    // The searches only reach the ancestors of both ends, which start unreachable
+    for(int direction = 0; direction < 2; direction++)
+        for(int vertex = direction == 0 ? start : final; vertex != -1; vertex = parent[vertex]) {
+            context.touch(vertex);
+            if(vertex != start) context.dist[vertex] = numeric_limits<double>::infinity();
+            if(vertex != final) context.invDist[vertex] = numeric_limits<double>::infinity();
+        }
+
+    double best = numeric_limits<double>::infinity();
+    int middle = -1;
+    int next[2] = {start, final};           // next ancestor of each direction
+    while(next[0] != -1 || next[1] != -1) {
+        // the direction with the lowest ranked vertex goes first, both of them once they share the ancestors
+        bool forwardTurn = next[0] != -1 && (next[1] == -1 || rank[next[0]] <= rank[next[1]]);
+        bool backwardTurn = next[1] != -1 && (next[0] == -1 || rank[next[1]] <= rank[next[0]]);
+        int vertex = forwardTurn ? next[0] : next[1];
+
+        // both searches reached the vertex, so there is a path through it
+        if(forwardTurn && backwardTurn && context.dist[vertex] + context.invDist[vertex] < best) {
+            best = context.dist[vertex] + context.invDist[vertex];
+            middle = vertex;
+        }
+
+        for(int direction = 0; direction < 2; direction++) {
+            bool forward = direction == 0;
+            if(!(forward ? forwardTurn : backwardTurn)) continue;
+            next[direction] = parent[vertex];
+
+            vector<double> &dist = forward ? context.dist : context.invDist;
+            vector<int> &path = forward ? context.path : context.invPath;
+            vector<int> &edgePath = forward ? context.edgePath : context.invEdgePath;
+
+            // no path through the arcs of the vertex can be shorter than the best path
+            if(dist[vertex] >= best) continue;
+
+            for(int arc = upOffsets[vertex]; arc < upOffsets[vertex + 1]; arc++) {
+                int target = upTargets[arc];
+                double newDist = dist[vertex] + upWeights[arc];
+
+                // Save the edge that has been processed to be drawn later (arcs of triangles aren't edges of the graph)
+                if(upEdgeIds[arc] != -1) processedEdges.insert(upEdgeIds[arc]);
+
+                if(newDist < dist[target]) {
+                    dist[target] = newDist;
+                    path[target] = vertex;
+                    edgePath[target] = arc;
+                }
+            }
+        }
+    }
+
+    if(middle == -1) return false;
+
+    // forward half, from the middle back to the start
+    vector<int> forwardArcs;
+    for(int vertex = middle; vertex != start; vertex = context.path[vertex])
+        forwardArcs.push_back(context.edgePath[vertex]);
+    reverse(forwardArcs.begin(), forwardArcs.end());
+
+    pathVertexes.push_back(start);
+    for(int arc : forwardArcs)
+        unpack(arc, pathVertexes.back(), pathVertexes, pathArcs);
+
+    // backward half, from the middle to the final vertex
+    for(int vertex = middle; vertex != final; vertex = context.invPath[vertex])
+        unpack(context.invEdgePath[vertex], vertex, pathVertexes, pathArcs);
+
+    return true;
+}
+
+bool CustomizableContractionHierarchy::isCustomized() const {
+    return customized;
+}
+
+int CustomizableContractionHierarchy::getNumArcs() const {
+    return upTargets.size();
+}
+
+/**
+ * @return - the number of vertexes of the longest path from a vertex to the root of its elimination tree,
+ * the most vertexes a query looks at in each direction
+ */
+int CustomizableContractionHierarchy::getHeight() const {
+    int height = 0;
+    vector<int> depth(order.size(), 1);
+    for(auto it = order.rbegin(); it != order.rend(); it++) {
+        if(parent[*it] != -1) depth[*it] = depth[parent[*it]] + 1;
+        height = max(height, depth[*it]);
+    }
+    return height;
+}
+
+/**
+ * @return number of bytes used by the order, the arcs and the weights
+ */
+size_t CustomizableContractionHierarchy::getMemoryUsage() const {
+    return (rank.size() + order.size() + parent.size() + upOffsets.size() + upSources.size() + upTargets.size() + csrArcs.size()
+            + upCsrArcs.size() + upEdgeIds.size() + firstHalf.size() + secondHalf.size()) * sizeof(int)
+           + upWeights.size() * sizeof(double);
+}
+
+#endif
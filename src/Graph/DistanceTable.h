@@ -0,0 +1,242 @@
+#pragma once
+#ifndef DISTANCE_TABLE_H_
+#define DISTANCE_TABLE_H_
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include "ContractionHierarchy.h"
+#include "SearchContext.h"
+
+using namespace std;
+
+/**
+ * Shortest distances (and optionally paths) between every source and every target of a set, computed with the
+ * contraction hierarchy of the graph by the bucket method:
+ * an upward search from each target leaves, in a bucket of each vertex it settles, the distance from that vertex
+ * to the target. Then an upward search from each source only has to scan the buckets of the vertexes it settles,
+ * so the whole table costs one upward search per source and per target instead of one search per pair.
+ */
+class DistanceTable {
+private:
+    struct BucketEntry {
+        int item;                   // position of the source or target in the table
+        double dist;                // distance between the vertex of the bucket and the source or target
+        int arc;                    // arc of the hierarchy used by the search to reach the vertex (-1 in its start)
+        int parent;                 // vertex where the search came from through that arc (-1 in its start)
+    };
+
+    vector<int> sources;            // index of the vertex of each source
+    vector<int> targets;
+    unordered_map<int, int> sourcePositions;    // position of each source in the table, by vertex index
+    unordered_map<int, int> targetPositions;
+
+    vector<double> distances;       // distances[source * numTargets + target]
+    vector<int> middles;            // vertex where the path between the source and the target peaks (-1 if none)
+
+    vector<int> backwardOffsets;    // bucket of each vertex, with the targets that reached it (size = numVertex + 1)
+    vector<BucketEntry> backwardBuckets;
+    vector<int> forwardOffsets;     // bucket of each vertex with the sources that reached it (only to build paths)
+    vector<BucketEntry> forwardBuckets;
+
+    void fillBuckets(const ContractionHierarchy &ch, SearchContext &context, const vector<int> &items, vector<int> &offsets, vector<BucketEntry> &buckets) const;
+    const BucketEntry *findEntry(const vector<int> &offsets, const vector<BucketEntry> &buckets, const int vertex, const int item) const;
+
+public:
+    void build(const ContractionHierarchy &ch, SearchContext &context, const vector<int> &sources, const vector<int> &targets, const bool keepPaths);
+    void clear();
+
+    int findSource(const int vertex) const;
+    int findTarget(const int vertex) const;
+    double distance(const int source, const int target) const;
+    bool getPath(const ContractionHierarchy &ch, const int source, const int target, vector<int> &pathVertexes, vector<int> &pathArcs) const;
+
+    int getNumSources() const;
+    int getNumTargets() const;
+    size_t getMemoryUsage() const;
+};
+
+/**
+ * @brief Runs an upward search from each item and saves the vertexes it settles into their buckets
+ * @param ch - contraction hierarchy of the graph
+ * @param context - search context used by the searches
+ * @param items - index of the vertex of each item
+ * @param offsets - filled with the start of the bucket of each vertex
+ * @param buckets - filled with the entries of every bucket, sorted by item inside each bucket
+ */
+void DistanceTable::fillBuckets(const ContractionHierarchy &ch, SearchContext &context, const vector<int> &items, vector<int> &offsets, vector<BucketEntry> &buckets) const {
+    int numVertex = ch.rank.size();
+    vector<pair<int, BucketEntry>> entries;
+    vector<int> settled;
+
+    for(int item = 0; item < (int) items.size(); item++) {
+        ch.upwardSearch(context, items[item], settled);
+        for(int vertex : settled) {
+            BucketEntry entry = {item, context.getDist(vertex), context.getEdgePath(vertex), context.getPath(vertex)};
+            entries.push_back(make_pair(vertex, entry));
+        }
+    }
+
+    // counting sort by vertex, which keeps the entries of each bucket in the order of the items
+    offsets.assign(numVertex + 1, 0);
+    for(const pair<int, BucketEntry> &entry : entries)
+        offsets[entry.first + 1]++;
+    for(int vertex = 0; vertex < numVertex; vertex++)
+        offsets[vertex + 1] += offsets[vertex];
+
+    vector<int> position(offsets.begin(), offsets.end() - 1);
+    buckets.resize(entries.size());
+    for(const pair<int, BucketEntry> &entry : entries)
+        buckets[position[entry.first]++] = entry.second;
+}
+
+/**
+ * @return - the entry of the item in the bucket of the vertex, nullptr if the item's search didn't reach it
+ */
+const DistanceTable::BucketEntry *DistanceTable::findEntry(const vector<int> &offsets, const vector<BucketEntry> &buckets, const int vertex, const int item) const {
+    auto it = lower_bound(buckets.begin() + offsets[vertex], buckets.begin() + offsets[vertex + 1], item, [](const BucketEntry &entry, const int item) {
+        return entry.item < item;
+    });
+    if(it == buckets.begin() + offsets[vertex + 1] || it->item != item) return nullptr;
+    return &*it;
+}
+
+/**
+ * @brief Computes the distance between every source and every target
+ * @param ch - contraction hierarchy of the graph
+ * @param context - search context used by the upward searches
+ * @param sources - index of the vertexes where the paths start (repeated vertexes are kept only once)
+ * @param targets - index of the vertexes where the paths end (repeated vertexes are kept only once)
+ * @param keepPaths - if true, the search trees of the sources are also kept, so getPath can be used
+ */
+void DistanceTable::build(const ContractionHierarchy &ch, SearchContext &context, const vector<int> &sources, const vector<int> &targets, const bool keepPaths) {
+    clear();
+    for(int vertex : sources)
+        if(sourcePositions.insert(make_pair(vertex, this->sources.size())).second) this->sources.push_back(vertex);
+    for(int vertex : targets)
+        if(targetPositions.insert(make_pair(vertex, this->targets.size())).second) this->targets.push_back(vertex);
+
+    int numTargets = this->targets.size();
+    distances.assign(this->sources.size() * numTargets, numeric_limits<double>::infinity());
+    middles.assign(this->sources.size() * numTargets, -1);
+
+    fillBuckets(ch, context, this->targets, backwardOffsets, backwardBuckets);
+    if(keepPaths) fillBuckets(ch, context, this->sources, forwardOffsets, forwardBuckets);
+
+    // every vertex settled by the search of a source that is in the bucket of a target is a path between them
+    vector<int> settled;
+    for(int source = 0; source < (int) this->sources.size(); source++) {
+        ch.upwardSearch(context, this->sources[source], settled);
+        double *row = &distances[source * numTargets];
+        int *rowMiddles = &middles[source * numTargets];
+
+        for(int vertex : settled) {
+            double dist = context.getDist(vertex);
+            for(int entry = backwardOffsets[vertex]; entry < backwardOffsets[vertex + 1]; entry++) {
+                const BucketEntry &target = backwardBuckets[entry];
+                if(dist + target.dist < row[target.item]) {
+                    row[target.item] = dist + target.dist;
+                    rowMiddles[target.item] = vertex;
+                }
+            }
+        }
+    }
+}
+
+void DistanceTable::clear() {
+    sources.clear();
+    targets.clear();
+    sourcePositions.clear();
+    targetPositions.clear();
+    distances.clear();
+    middles.clear();
+    backwardOffsets.clear();
+    backwardBuckets.clear();
+    forwardOffsets.clear();
+    forwardBuckets.clear();
+}
+
+/**
+ * @param vertex - index of a vertex
+ * @return - the position of the vertex in the sources of the table, -1 if it isn't one of them
+ */
+int DistanceTable::findSource(const int vertex) const {
+    auto it = sourcePositions.find(vertex);
+    return it == sourcePositions.end() ? -1 : it->second;
+}
+
+/**
+ * @param vertex - index of a vertex
+ * @return - the position of the vertex in the targets of the table, -1 if it isn't one of them
+ */
+int DistanceTable::findTarget(const int vertex) const {
+    auto it = targetPositions.find(vertex);
+    return it == targetPositions.end() ? -1 : it->second;
+}
+
+/**
+ * @param source - position of the source in the table
+ * @param target - position of the target in the table
+ * @return - the length of the shortest path from the source to the target (infinite if there is none)
+ */
+double DistanceTable::distance(const int source, const int target) const {
+    return distances[source * targets.size() + target];
+}
+
+/**
+ * @brief Builds the path between a source and a target from the search trees kept in the buckets,
+ * replacing the shortcuts by the arcs they represent
+ * @param ch - contraction hierarchy the table was built with
+ * @param source - position of the source in the table
+ * @param target - position of the target in the table
+ * @param pathVertexes - filled with the vertexes of the path, from the source to the target
+ * @param pathArcs - filled with the csr arcs of the path (pathArcs[i] connects pathVertexes[i] and pathVertexes[i + 1])
+ * @return - true if there is a path and the table was built keeping the paths
+ */
+bool DistanceTable::getPath(const ContractionHierarchy &ch, const int source, const int target, vector<int> &pathVertexes, vector<int> &pathArcs) const {
+    pathVertexes.clear();
+    pathArcs.clear();
+
+    int middle = middles[source * targets.size() + target];
+    if(middle == -1 || forwardBuckets.empty()) return false;
+
+    // forward half, from the middle back to the source
+    vector<int> forwardArcs;
+    for(const BucketEntry *entry = findEntry(forwardOffsets, forwardBuckets, middle, source); entry->parent != -1;
+        entry = findEntry(forwardOffsets, forwardBuckets, entry->parent, source))
+        forwardArcs.push_back(entry->arc);
+    reverse(forwardArcs.begin(), forwardArcs.end());
+
+    pathVertexes.push_back(sources[source]);
+    for(int arc : forwardArcs)
+        ch.unpack(arc, pathVertexes.back(), pathVertexes, pathArcs);
+
+    // backward half, from the middle to the target
+    for(int vertex = middle; vertex != targets[target];) {
+        const BucketEntry *entry = findEntry(backwardOffsets, backwardBuckets, vertex, target);
+        ch.unpack(entry->arc, vertex, pathVertexes, pathArcs);
+        vertex = entry->parent;
+    }
+
+    return true;
+}
+
+int DistanceTable::getNumSources() const {
+    return sources.size();
+}
+
+int DistanceTable::getNumTargets() const {
+    return targets.size();
+}
+
+/**
+ * @return number of bytes used by the table and the buckets
+ */
+size_t DistanceTable::getMemoryUsage() const {
+    return distances.size() * sizeof(double) + middles.size() * sizeof(int)
+           + (backwardOffsets.size() + forwardOffsets.size()) * sizeof(int)
+           + (backwardBuckets.size() + forwardBuckets.size()) * sizeof(BucketEntry);
+}
+
+#endif
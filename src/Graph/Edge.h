@@ -30,10 +30,11 @@ class Edge {
         int getId() const;
         Vertex* getDest() const;
         double getWeight() const;
-        static vector<int> getIds(vector<Edge> edges);
+        static vector<int> getIds(const vector<Edge> &edges);
 
         friend class Graph;
         friend class Vertex;
+        friend class CSRGraph;
 };
 
 int Edge::getId() const {
@@ -48,9 +49,10 @@ double Edge::getWeight() const {
 	return this->weight;
 }
 
-vector<int> Edge::getIds(vector<Edge> edges)  {
+vector<int> Edge::getIds(const vector<Edge> &edges)  {
     vector<int> ids;
-    for(Edge edge : edges) ids.push_back(edge.id);
+    ids.reserve(edges.size());
+    for(const Edge &edge : edges) ids.push_back(edge.id);
     return ids;
 }
 
@@ -10,29 +10,118 @@
 #include <cmath>
 #include <chrono>
 #include "MutablePriorityQueue.h"
+#include "RadixHeap.h"
 #include "Vertex.h"
+#include "CSRGraph.h"
+#include "SearchContext.h"
+#include "Arena.h"
+#include "ContractionHierarchy.h"
+#include "CustomizableContractionHierarchy.h"
+#include "Landmarks.h"
+#include "ArcFlags.h"
+#include "HubLabels.h"
+#include "DistanceTable.h"
+#include "PoiMatrix.h"
+#include "ShortestPathTree.h"
+#include "TaskScheduler.h"
 using namespace std;
 using namespace std::chrono;
 
+// Priority queue of the searches of the graph: the binary heap, or the radix heap if GRAPH_RADIX_HEAP is defined
+#ifdef GRAPH_RADIX_HEAP
+typedef RadixHeap SearchQueue;
+#else
+typedef MutablePriorityQueue<double> SearchQueue;
+#endif
+
 class Graph {
+public:
+    enum VertexOrder {READ_ORDER, HILBERT_ORDER, BFS_ORDER};
+    enum SearchAlgorithm {DIJKSTRA, ORIENTED_SEARCH, BIDIRECTIONAL, CONTRACTION_HIERARCHY, ARC_FLAGS, CUSTOMIZABLE_CONTRACTION_HIERARCHY};
+
+    // shortest path query of a batch (see shortestPaths)
+    struct PathQuery {
+        int origin;                 // id of the vertex where the path starts
+        int dest;                   // id of the vertex where the path ends
+        SearchAlgorithm algorithm;
+    };
+
+    // answer to a PathQuery
+    struct PathResult {
+        bool found = false;         // false if a vertex doesn't exist or there is no path
+        double dist = 0;            // length of the path
+        vector<Edge> edges;         // edges of the path, from the origin to the destination
+        int processedEdges = 0;     // edges processed by the search (in both directions in the bidirectional one)
+        double time = 0;            // time taken by the search and the path, in microseconds
+    };
+
 private:
     int offsetX;    // for Graph Viewer
     int offsetY;    // for Graph Viewer
 
+    Arena<Vertex> vertexArena{4096};          // owns the vertexes, released together with the graph
     vector<Vertex*> vertexSet;
-    unordered_map<int, Vertex*> vertexIndexes;    //search for id and return vertex (much faster)
-
-    vector<vector<double>> minDistance;       // used for floyd Warshall algorithm
-    vector<vector<Vertex*>> next;             // used for floyd Warshall algorithm
-    void dfsVisit(Vertex *origin) const;      // pre processing
+    unordered_map<int, int> vertexIndexes;    // translates the id of a vertex to its index (only used at the API boundary)
+
+    CSRGraph csr;                             // contiguous copy of the edges used by the searches
+    bool csrUpdated = false;                  // false when the edges changed since the csr was built
+    void updateCSR();
+
+    ContractionHierarchy ch;                  // built from the csr the first time it is needed
+    bool chUpdated = false;                   // false when the csr changed since the hierarchy was built
+    void updateContractionHierarchy();
+    void setContextPath(SearchContext &context, const int start, const vector<int> &pathVertexes, const vector<int> &pathArcs) const;
+
+    CustomizableContractionHierarchy cch;     // order and arcs built from the csr, weights set by the customization
+    bool cchUpdated = false;                  // false when the csr changed since the order and the arcs were built
+    bool cchCustomized = false;               // false when the weights changed since the last customization
+    void updateCustomizableHierarchy();
+
+    Landmarks landmarks;                      // lower bounds used by the oriented searches (ALT)
+    int numLandmarks = 0;                     // 0 if the searches use only the euclidean distance
+    Landmarks::Strategy landmarkStrategy = Landmarks::AVOID;
+    bool landmarksUpdated = false;            // false when the csr changed since the landmarks were chosen
+    void updateLandmarks();
+
+    ArcFlags arcFlags;                        // flags that prune the arcs of dijkstraArcFlags
+    int numArcFlagCells = 32;
+    bool arcFlagsUpdated = false;             // false when the csr changed since the flags were computed
+    void updateArcFlags();
+
+    HubLabels hubLabels;                      // exact distances between any two vertexes, built from the hierarchy
+    bool hubLabelsUpdated = false;            // false when the hierarchy changed since the labels were built
+    void updateHubLabels();
+
+    SearchContext defaultContext;             // used by the searches that don't receive a context
+    TaskScheduler *taskScheduler = &TaskScheduler::shared();  // runs the batches, the matrixes, floyd warshall and the arc flags
+    unordered_map<int, ShortestPathTree> centralTrees;    // shortest path trees of the centrals used, by index
+    const ShortestPathTree *centralTree = nullptr;        // tree of the current central (dijkstraOriginal)
+    uint64_t checksum = 0;                    // checksum of the csr and the ids of the vertexes
+    bool checksumUpdated = false;             // false when the csr changed since the checksum was computed
+    Edge getArcEdge(const int arc, const int vertex, const int previous) const;
+    void oneToManySearch(SearchContext &context, const int start, const vector<int> &targets) const;
+    inline double landmarkDistance(const int vertex, const int dest, const double distance) const;
+
+    vector<float> minDistance;                // used for floyd Warshall algorithm, minDistance[i * floydSize + j]
+    vector<int> next;                         // used for floyd Warshall algorithm, index of the next vertex of each path
+    int floydSize = 0;                        // size of the side of the matrix, rounded up to a multiple of the block
+    const static int floydBlock = 64;         // 64 x 64 floats (16KB) fit in the L1 cache
+    void floydWarshallBlock(const int k0, const int i0, const int j0);
+    vector<int> componentSizes;               // sizes of the components found by the last preProcess
+    void dfsVisit(Vertex *origin, vector<int> &component, const int label) const;    // pre processing
+    void tarjanVisit(Vertex *origin, vector<int> &component, vector<int> &low, vector<int> &order, int &counter, int &numComponents) const;
+    static unsigned hilbertKey(unsigned x, unsigned y);               // vertex reordering
 
     const static int infinite = 99999999;
 
 public:
     Vertex* findVertex(const int &id) const;
+    int findVertexIndex(const int &id) const;
+    Vertex* getVertex(const int index) const;
     bool addVertex(const int &id, const int &x, const int &y);
     void addPointOfInterest(Vertex* vertex);
     bool addEdge(const int &id, const int &origin, const int &dest);
+    bool setEdgeWeights(const vector<pair<int, double>> &weights);
 
     void setOffsetX(int x);
     void setOffsetY(int y);
@@ -40,24 +129,68 @@ public:
     int getOffsetY();
 
     int getNumVertex() const;
-    vector<Vertex*> getVertexSet() const;
+    const vector<Vertex*> &getVertexSet() const;
+    const CSRGraph &getCSR();
+    uint64_t getChecksum();
+    const ContractionHierarchy &getContractionHierarchy();
+    const CustomizableContractionHierarchy &getCustomizableHierarchy();
+    void setLandmarks(const int numLandmarks, const Landmarks::Strategy strategy = Landmarks::AVOID);
+    const Landmarks &getLandmarks();
+    void setArcFlagCells(const int numCells);
+    const ArcFlags &getArcFlags();
+    const HubLabels &getHubLabels();
+    void setScheduler(TaskScheduler &scheduler);
 
     // pre processing
     bool preProcess(int origin);
+    int findComponents(vector<int> &component, vector<int> &sizes, const bool directed) const;
+    const vector<int> &getComponentSizes() const;
+    void reorderVertexes(const VertexOrder order);
 
     // dijkstra
-    Vertex* dijkstraInitCentral(const int origin);
-    Vertex* dijkstraInit(const int origin);
-    Vertex* dijkstraBackwardsInit(const int dest);
+    int dijkstraInit(SearchContext &context, const int origin) const;
+    int dijkstraBackwardsInit(SearchContext &context, const int dest) const;
     bool dijkstraOriginal(const int origin);
+    bool loadCentralTree(const string &file, const int origin);
+    bool saveCentralTree(const string &file) const;
     bool dijkstra(const int origin, const int dest, unordered_set<int> &processedEdges);
+    bool dijkstra(SearchContext &context, const int origin, const int dest, unordered_set<int> &processedEdges) const;
+    bool dijkstraOneToMany(const int origin, const vector<int> &targets, vector<double> &distances);
+    bool dijkstraOneToMany(SearchContext &context, const int origin, const vector<int> &targets, vector<double> &distances) const;
     int getPathTo(const int dest, vector<Edge> &edges) const;
+    int getPathTo(const SearchContext &context, const int dest, vector<Edge> &edges) const;
     int getPathFromCentralTo(const int dest, vector<Edge> &edges) const;
 
     // dijkstra related
-    double heuristicDistance(Vertex *origin, Vertex *dest);
-    bool dijkstraOrientedSearch(const int origin, const int dest, unordered_set<int> &processedEdges) ;
+    double heuristicDistance(Vertex *origin, Vertex *dest) const;
+    double landmarkDistance(Vertex *origin, Vertex *dest) const;
+    bool dijkstraOrientedSearch(const int origin, const int dest, unordered_set<int> &processedEdges);
+    bool dijkstraOrientedSearch(SearchContext &context, const int origin, const int dest, unordered_set<int> &processedEdges) const;
     bool dijkstraBidirectional(const int origin, const int dest, unordered_set<int> &processedEdges, unordered_set<int> &processedEdgesInv);
+    bool dijkstraBidirectional(SearchContext &context, const int origin, const int dest, unordered_set<int> &processedEdges, unordered_set<int> &processedEdgesInv) const;
+
+    // arc flags
+    bool dijkstraArcFlags(const int origin, const int dest, unordered_set<int> &processedEdges);
+    bool dijkstraArcFlags(SearchContext &context, const int origin, const int dest, unordered_set<int> &processedEdges) const;
+
+    // contraction hierarchies
+    bool contractionHierarchySearch(const int origin, const int dest, unordered_set<int> &processedEdges);
+    bool contractionHierarchySearch(SearchContext &context, const int origin, const int dest, unordered_set<int> &processedEdges) const;
+    double hubLabelDistance(Vertex *origin, Vertex *dest);
+
+    // customizable contraction hierarchies
+    bool customizableHierarchySearch(const int origin, const int dest, unordered_set<int> &processedEdges);
+    bool customizableHierarchySearch(SearchContext &context, const int origin, const int dest, unordered_set<int> &processedEdges) const;
+
+    // batches of queries
+    bool shortestPaths(const vector<PathQuery> &queries, vector<PathResult> &results);
+
+    // distance tables
+    bool distanceTable(DistanceTable &table, const vector<int> &sources, const vector<int> &targets, const bool keepPaths);
+    bool distanceTable(SearchContext &context, DistanceTable &table, const vector<int> &sources, const vector<int> &targets, const bool keepPaths) const;
+    int getTablePath(const DistanceTable &table, const int origin, const int dest, vector<Edge> &edges) const;
+    bool poiMatrix(PoiMatrix &matrix, const vector<int> &points);
+    int getTablePath(const PoiMatrix &matrix, const int origin, const int dest, vector<Edge> &edges) const;
 
     // all pairs
     void floydWarshallShortestPath();
@@ -66,28 +199,141 @@ public:
 
 /**************** Pre processing ************/
 /**
- * @brief Starts from the origin vertex and runs through the graph using depth first search
+ * @brief Starts from the origin vertex and runs through the graph using depth first search, following the
+ * edges in both directions (the same way the searches do), and labels every vertex it reaches.
+ * Uses an explicit stack instead of recursion, so the depth of the search is not limited by the call stack
  * @param origin - Pointer to where the vertex starts
+ * @param component - component of each vertex (-1 if not visited yet), indexed by the vertex index
+ * @param label - component given to the vertexes reached
  */
-void Graph::dfsVisit(Vertex *origin) const {
+void Graph::dfsVisit(Vertex *origin, vector<int> &component, const int label) const {
+    vector<Vertex*> stack;
+    stack.push_back(origin);
     // Set the vertex as visited
-    origin->visited = true;
+    component[origin->index] = label;
+
+    while(!stack.empty()) {
+        Vertex *vertex = stack.back();
+        stack.pop_back();
+
+        // Iterate over all the neighbours
+        for(const Edge &edge : vertex->adj)
+            // If the neighbour hasn't been visited, mark it and visit it later
+            if(component[edge.dest->index] == -1) {
+                component[edge.dest->index] = label;
+                stack.push_back(edge.dest);
+            }
+
+        for(const Edge &edge : vertex->invAdj)
+            // If the neighbour hasn't been visited, mark it and visit it later
+            if(component[edge.origin->index] == -1) {
+                component[edge.origin->index] = label;
+                stack.push_back(edge.origin);
+            }
+    }
+}
+
+/**
+ * @brief Tarjan's algorithm, following only the outgoing edges, starting from the origin vertex.
+ * The recursion is replaced by an explicit stack of (vertex, next edge) pairs
+ * @param origin - Pointer to where the search starts
+ * @param component - strongly connected component of each vertex (-1 if not assigned yet)
+ * @param low - lowest discovery order reachable from each vertex
+ * @param order - discovery order of each vertex (-1 if not visited yet)
+ * @param counter - number of vertexes discovered so far, updated with the new ones
+ * @param numComponents - number of components found so far, updated with the new ones
+ */
+void Graph::tarjanVisit(Vertex *origin, vector<int> &component, vector<int> &low, vector<int> &order, int &counter, int &numComponents) const {
+    vector<pair<Vertex*, size_t>> callStack;  // vertexes being visited and the position of the next edge to follow
+    vector<Vertex*> sccStack;                 // visited vertexes without a component yet
+
+    order[origin->index] = low[origin->index] = counter++;
+    callStack.push_back(make_pair(origin, (size_t) 0));
+    sccStack.push_back(origin);
+
+    while(!callStack.empty()) {
+        Vertex *vertex = callStack.back().first;
+        size_t &next = callStack.back().second;
+
+        if(next < vertex->adj.size()) {
+            Vertex *child = vertex->adj[next++].dest;
+            if(order[child->index] == -1) {
+                // visit the child before the remaining edges of this vertex
+                order[child->index] = low[child->index] = counter++;
+                callStack.push_back(make_pair(child, (size_t) 0));
+                sccStack.push_back(child);
+            }
+            else if(component[child->index] == -1)
+                low[vertex->index] = min(low[vertex->index], order[child->index]);
+            continue;
+        }
+
+        // every edge was followed, so the vertex is done
+        callStack.pop_back();
+        if(!callStack.empty()) {
+            Vertex *parent = callStack.back().first;
+            low[parent->index] = min(low[parent->index], low[vertex->index]);
+        }
+
+        // the vertex is the root of a component, made of it and the vertexes above it in the stack
+        if(low[vertex->index] == order[vertex->index]) {
+            Vertex *member;
+            do {
+                member = sccStack.back();
+                sccStack.pop_back();
+                component[member->index] = numComponents;
+            } while(member != vertex);
+            numComponents++;
+        }
+    }
+}
+
+/**
+ * @brief Splits the graph into components, in time linear in the size of the graph
+ * @param component - filled with the component of each vertex, indexed by the vertex index
+ * @param sizes - filled with the number of vertexes of each component
+ * @param directed - if true, the strongly connected components (following the edges only in their direction,
+ * with Tarjan's algorithm), otherwise the components of the graph as the searches see it (edges in both directions)
+ * @return - the number of components
+ */
+int Graph::findComponents(vector<int> &component, vector<int> &sizes, const bool directed) const {
+    int numVertex = vertexSet.size(), numComponents = 0;
+    component.assign(numVertex, -1);
+
+    if(directed) {
+        vector<int> low(numVertex), order(numVertex, -1);
+        int counter = 0;
+        for(Vertex *vertex : vertexSet)
+            if(order[vertex->index] == -1)
+                tarjanVisit(vertex, component, low, order, counter, numComponents);
+    }
+    else {
+        for(Vertex *vertex : vertexSet)
+            if(component[vertex->index] == -1)
+                dfsVisit(vertex, component, numComponents++);
+    }
 
-    // Iterate over all the neighbours
-    for(auto edge : origin->adj)
-        // If the neighbour hasn't been visited, run dfsVisit with that vertex
-        if(!edge.dest->visited)
-            dfsVisit(edge.dest);
+    sizes.assign(numComponents, 0);
+    for(int label : component)
+        sizes[label]++;
 
-    for(auto edge : origin->invAdj)
-        // If the neighbour hasn't been visited, run dfsVisit with that vertex
-        if(!edge.origin->visited)
-            dfsVisit(edge.origin);
+    return numComponents;
 }
 
 /**
- * Eliminates all nodes from the graph that do not belong to the strongly connected component
- * that the node(origin) belongs.
+ * @return - the number of vertexes of each component of the graph before the last preProcess,
+ * as found by findComponents (empty if the graph wasn't pre processed)
+ */
+const vector<int> &Graph::getComponentSizes() const {
+    return componentSizes;
+}
+
+/**
+ * Eliminates all nodes from the graph that do not belong to the connected component that the node(origin) belongs.
+ * The searches follow the edges in both directions, so two vertexes of the same component always have a path
+ * between them, and every vertex removed is unreachable from the origin.
+ * The components are found by findComponents and the vertexes removed in a single pass, together with the edges
+ * (in both directions) that point to them, so this runs in time linear in the size of the graph.
  * @param origin vertex do be processed
  * @return
  */
@@ -95,32 +341,151 @@ bool Graph::preProcess(int origin) {
     auto orig = findVertex(origin);
     if (orig == nullptr) return false;
 
-    for(auto vertex : vertexSet)
-        vertex->visited = false;
+    vector<int> component;
+    findComponents(component, componentSizes, false);
+
+    // marks the vertexes that stay (uses the old indexes)
+    vector<bool> visited(vertexSet.size(), false);
+    for(size_t i = 0; i < vertexSet.size(); i++)
+        visited[i] = component[i] == component[orig->index];
+
+    // deletes the edges of the remaining vertexes that lead to deleted vertexes (uses the old indexes)
+    for(Vertex *vertex : vertexSet) {
+        if(!visited[vertex->index]) continue;
+        vertex->adj.erase(remove_if(vertex->adj.begin(), vertex->adj.end(), [&visited](const Edge &edge) {
+            return !visited[edge.dest->index];
+        }), vertex->adj.end());
+        vertex->invAdj.erase(remove_if(vertex->invAdj.begin(), vertex->invAdj.end(), [&visited](const Edge &edge) {
+            return !visited[edge.origin->index];
+        }), vertex->invAdj.end());
+    }
+
+    // deletes nodes, moving the remaining ones to the front of the vector
+    // (the vertexes belong to the arena, so only the memory of their edges is released now)
+    int numVertex = 0;
+    for(Vertex *vertex : vertexSet) {
+        if(visited[vertex->index]) vertexSet[numVertex++] = vertex;
+        else {
+            vector<Edge>().swap(vertex->adj);
+            vector<Edge>().swap(vertex->invAdj);
+        }
+    }
+    vertexSet.resize(numVertex);
+
+    // the remaining vertexes are renumbered so the indexes stay contiguous
+    vertexIndexes.clear();
+    for(size_t i = 0; i < vertexSet.size(); i++) {
+        vertexSet[i]->index = i;
+        vertexIndexes.insert(pair<int, int>(vertexSet[i]->id, i));
+    }
 
-    dfsVisit(orig);
+    csrUpdated = false;
+    return true;
+}
 
-    set<int> removed;
-    // deletes nodes
-    for(auto it = vertexSet.begin(); it != vertexSet.end(); it++) {
-        if(!(*it)->visited) {
-            vertexIndexes.erase((*it)->getId());
-            removed.insert((*it)->getId());
-            it = vertexSet.erase(it);
-            it--;
+/**
+ * @brief Position of a point of a 2^16 x 2^16 grid along the Hilbert curve that fills the grid
+ * @param x - coordinate of the point in the x axis, between 0 and 65535
+ * @param y - coordinate of the point in the y axis, between 0 and 65535
+ * @return - distance of the point to the start of the curve
+ */
+unsigned Graph::hilbertKey(unsigned x, unsigned y) {
+    unsigned key = 0;
+    for(unsigned s = 1u << 15; s > 0; s /= 2) {
+        unsigned rx = (x & s) > 0;
+        unsigned ry = (y & s) > 0;
+        key += s * s * ((3 * rx) ^ ry);
+
+        // rotate the quadrant so the curve stays continuous
+        if(ry == 0) {
+            if(rx == 1) {
+                x = s - 1 - x;
+                y = s - 1 - y;
+            }
+            swap(x, y);
         }
     }
+    return key;
+}
+
+/**
+ * @brief Renumbers the vertexes so that vertexes close to each other in the map get close indexes.
+ * Since the CSR arrays and the search contexts are indexed by the vertex index, this keeps the data
+ * touched by a search in fewer cache lines. The ids and the edges are not changed.
+ * @param order - HILBERT_ORDER sorts the vertexes along a Hilbert curve over their positions,
+ * BFS_ORDER numbers them in breadth first order (following the edges in both directions),
+ * READ_ORDER keeps the current order
+ */
+void Graph::reorderVertexes(const VertexOrder order) {
+    if(order == READ_ORDER || vertexSet.empty()) return;
+
+    vector<Vertex*> ordered;
+    ordered.reserve(vertexSet.size());
+
+    if(order == HILBERT_ORDER) {
+        double minX = numeric_limits<double>::max(), minY = numeric_limits<double>::max();
+        double maxX = numeric_limits<double>::lowest(), maxY = numeric_limits<double>::lowest();
+        for(Vertex *vertex : vertexSet) {
+            minX = min(minX, vertex->pos.getX());
+            minY = min(minY, vertex->pos.getY());
+            maxX = max(maxX, vertex->pos.getX());
+            maxY = max(maxY, vertex->pos.getY());
+        }
+
+        // scale the bounding box of the map to the grid of the curve
+        double scale = 65535 / max(1.0, max(maxX - minX, maxY - minY));
+        vector<pair<unsigned, Vertex*>> keys;
+        keys.reserve(vertexSet.size());
+        for(Vertex *vertex : vertexSet) {
+            unsigned x = (vertex->pos.getX() - minX) * scale;
+            unsigned y = (vertex->pos.getY() - minY) * scale;
+            keys.push_back(make_pair(hilbertKey(x, y), vertex));
+        }
 
-    // deletes outgoing edges of the deleted nodes (no need to delete from invAdj as Vertex is a pointer)
-    for(auto vertex : vertexSet) {
-        for(auto it = vertex->adj.begin(); it != vertex->adj.end(); it++)
-            if(removed.find(it->getDest()->getId()) != removed.end()) {
-                it = vertex->adj.erase(it);
-                it--;
+        // stable so vertexes in the same cell keep their relative order
+        stable_sort(keys.begin(), keys.end(), [](const pair<unsigned, Vertex*> &a, const pair<unsigned, Vertex*> &b) {
+            return a.first < b.first;
+        });
+        for(auto &key : keys)
+            ordered.push_back(key.second);
+    }
+    else {
+        vector<bool> visited(vertexSet.size(), false);
+        queue<Vertex*> q;
+
+        // one breadth first search for each connected component, in the current order
+        for(Vertex *start : vertexSet) {
+            if(visited[start->index]) continue;
+            visited[start->index] = true;
+            q.push(start);
+
+            while(!q.empty()) {
+                Vertex *vertex = q.front();
+                q.pop();
+                ordered.push_back(vertex);
+
+                for(const Edge &edge : vertex->adj)
+                    if(!visited[edge.dest->index]) {
+                        visited[edge.dest->index] = true;
+                        q.push(edge.dest);
+                    }
+                for(const Edge &edge : vertex->invAdj)
+                    if(!visited[edge.origin->index]) {
+                        visited[edge.origin->index] = true;
+                        q.push(edge.origin);
+                    }
             }
+        }
     }
 
-    return true;
+    vertexSet = ordered;
+    vertexIndexes.clear();
+    for(size_t i = 0; i < vertexSet.size(); i++) {
+        vertexSet[i]->index = i;
+        vertexIndexes.insert(pair<int, int>(vertexSet[i]->id, i));
+    }
+
+    csrUpdated = false;
 }
 
 /**************** Usual operations ************/
@@ -132,7 +497,26 @@ bool Graph::preProcess(int origin) {
  */
 Vertex* Graph::findVertex(const int &id) const {
     auto it = vertexIndexes.find(id);
-    return it == vertexIndexes.end() ? nullptr : it->second;
+    return it == vertexIndexes.end() ? nullptr : vertexSet[it->second];
+}
+
+/**
+ * @brief translates the id of a vertex to its index in the graph
+ * @param id - id of the vertex that we are looking for
+ * @return - the index of the vertex, -1 if it doesn't exist
+ */
+int Graph::findVertexIndex(const int &id) const {
+    auto it = vertexIndexes.find(id);
+    return it == vertexIndexes.end() ? -1 : it->second;
+}
+
+/**
+ * @brief gets a vertex by its index, without any lookup
+ * @param index - index of the vertex, between 0 and getNumVertex() - 1
+ * @return - a pointer to the vertex
+ */
+Vertex* Graph::getVertex(const int index) const {
+    return vertexSet[index];
 }
 
 /**
@@ -145,9 +529,11 @@ Vertex* Graph::findVertex(const int &id) const {
 bool Graph::addVertex(const int &id, const int &x, const int &y) {
     if (findVertex(id) != nullptr) return false;
 
-    auto vertex = new Vertex(id, x, y);
+    auto vertex = vertexArena.create(id, x, y);
+    vertex->index = vertexSet.size();
     vertexSet.push_back(vertex);
-    vertexIndexes.insert(pair<int, Vertex*>(id, vertex));
+    vertexIndexes.insert(pair<int, int>(id, vertex->index));
+    csrUpdated = false;
 
     return true;
 }
@@ -166,6 +552,67 @@ bool Graph::addEdge(const int &id, const int &origin, const int &dest) {
         return false;
 
     v1->addEdge(id, v2, v1->pos.euclideanDistance(v2->pos));
+    csrUpdated = false;
+
+    return true;
+}
+
+/**
+ * @brief Changes the weight of some edges (congestion, closed roads) without building the csr again. The csr and
+ * both edge lists of the vertexes get the new weights. What depends on the weights (contraction hierarchy, landmarks,
+ * arc flags, hub labels) is built again the next time it is needed, except the customizable contraction hierarchy,
+ * which keeps its order and arcs and is only customized with the new weights. The trees of the centrals and the
+ * floyd warshall matrix are dropped: dijkstraOriginal and floydWarshallShortestPath must run again.
+ * A weight smaller than the length of the edge makes the euclidean heuristic of the oriented searches too big,
+ * and then they may miss the shortest path
+ * @param weights - id of each edge to change and its new weight (infinite closes the edge)
+ * @return - true if every edge exists and every weight is valid, otherwise nothing is changed
+ */
+bool Graph::setEdgeWeights(const vector<pair<int, double>> &weights) {
+    updateCSR();
+
+    unordered_map<int, double> newWeights;
+    for(const pair<int, double> &weight : weights) {
+        if(!(weight.second >= 0)) return false;
+        newWeights[weight.first] = weight.second;
+    }
+
+    // The csr arcs are in the same order as the adjacency lists, so the position of an arc also gives its Edge
+    vector<pair<int, int>> changed;           // vertex and csr arc of each edge to change
+    unordered_set<int> found;
+    for(int vertex = 0; vertex < getNumVertex(); vertex++)
+        for(int arc = csr.offsets[vertex]; arc < csr.offsets[vertex + 1]; arc++)
+            if(newWeights.count(csr.edgeIds[arc])) {
+                changed.push_back(make_pair(vertex, arc));
+                found.insert(csr.edgeIds[arc]);
+            }
+    if(found.size() != newWeights.size()) return false;
+
+    for(const pair<int, int> &edge : changed) {
+        int id = csr.edgeIds[edge.second];
+        double weight = newWeights[id];
+        Vertex *origin = vertexSet[edge.first];
+        csr.weights[edge.second] = weight;
+        origin->adj[edge.second - csr.offsets[edge.first]].weight = weight;
+
+        // The ingoing lists keep the order the edges were added in, so the copy is found by its id
+        for(Edge &inEdge : vertexSet[csr.targets[edge.second]]->invAdj)
+            if(inEdge.id == id && inEdge.origin == origin) inEdge.weight = weight;
+    }
+    for(int arc = 0; arc < csr.getNumArcs(); arc++)
+        csr.invWeights[arc] = csr.weights[csr.invArcs[arc]];
+
+    chUpdated = false;
+    cchCustomized = false;
+    landmarksUpdated = false;
+    arcFlagsUpdated = false;
+    hubLabelsUpdated = false;
+    checksumUpdated = false;
+    centralTrees.clear();
+    centralTree = nullptr;
+    minDistance.clear();
+    next.clear();
+    floydSize = 0;
 
     return true;
 }
@@ -190,217 +637,445 @@ int Graph::getNumVertex() const {
     return vertexSet.size();
 }
 
-vector<Vertex*> Graph::getVertexSet() const {
+const vector<Vertex*> &Graph::getVertexSet() const {
     return vertexSet;
 }
 
-/**************** Dijkstra ************/
+/**
+ * @brief Rebuilds the CSR arrays if vertexes or edges were added or removed since the last build
+ */
+void Graph::updateCSR() {
+    if(csrUpdated) return;
+    csr.build(vertexSet);
+    csrUpdated = true;
+    chUpdated = false;
+    cchUpdated = false;
+    landmarksUpdated = false;
+    arcFlagsUpdated = false;
+    hubLabelsUpdated = false;
+    checksumUpdated = false;
+
+    // the trees of the centrals are indexed by the old indexes
+    centralTrees.clear();
+    centralTree = nullptr;
+}
 
 /**
- * @brief Initializes all the camps of the vertexes related to the central with the default values
- * @param origin - id of the vertex that represents the origin of the graph
- * @return a pointer to the vertex that represents the origin of the graph
+ * @return the CSR representation of the edges of the graph, built from the current adjacency lists
  */
-Vertex* Graph::dijkstraInitCentral(const int origin) {
-    for(auto vertex : vertexSet) {
-        vertex->visited = false;
-        vertex->distCentral = infinite;
-        vertex->pathCentral = NULL;
-        vertex->edgePathCentral = Edge();
-        vertex->queueIndex = 0;
-    }
+const CSRGraph &Graph::getCSR() {
+    updateCSR();
+    return csr;
+}
 
-    auto start = findVertex(origin);
-    start->distCentral = 0;
+/**
+ * @return a checksum (64 bit FNV-1a) of the edges of the csr and of the id of each vertex index, which changes
+ * whenever the searches could give a different result, so it identifies the graph data saved to files
+ */
+uint64_t Graph::getChecksum() {
+    updateCSR();
+    if(checksumUpdated) return checksum;
+
+    uint64_t hash = 14695981039346656037ULL;
+    auto add = [&hash](const void *data, const size_t size) {
+        const unsigned char *bytes = (const unsigned char *) data;
+        for(size_t i = 0; i < size; i++) {
+            hash ^= bytes[i];
+            hash *= 1099511628211ULL;
+        }
+    };
 
-    return start;
+    for(Vertex *vertex : vertexSet) add(&vertex->id, sizeof(int));
+    add(csr.offsets.data(), csr.offsets.size() * sizeof(int));
+    add(csr.targets.data(), csr.targets.size() * sizeof(int));
+    add(csr.weights.data(), csr.weights.size() * sizeof(double));
+    add(csr.edgeIds.data(), csr.edgeIds.size() * sizeof(int));
+
+    checksum = hash;
+    checksumUpdated = true;
+    return checksum;
+}
+
+/**
+ * @brief Contracts the graph again if the csr changed since the contraction hierarchy was built
+ */
+void Graph::updateContractionHierarchy() {
+    updateCSR();
+    if(chUpdated) return;
+    ch.build(csr);
+    chUpdated = true;
+    hubLabelsUpdated = false;
 }
 
 /**
- * @brief Initializes all the camps of the vertexes with the default values
- * @param origin - id of the vertex that represents the origin of the graph
- * @return a pointer to the vertex that represents the origin of the graph
+ * @return the contraction hierarchy of the graph, built if the graph changed since the last time
  */
-Vertex* Graph::dijkstraInit(const int origin) {
-    for(auto vertex : vertexSet) {
-        vertex->visited = false;
-        vertex->invVisited = false;
-        vertex->dist = infinite;
-        vertex->path = nullptr;
-        vertex->edgePath = Edge();
-        vertex->invDist = infinite;
-        vertex->invPath = nullptr;
-        vertex->invEdgePath = Edge();
-        vertex->heuristicValue = infinite;
-        vertex->invHeuristicValue = infinite;
-        vertex->queueIndex = 0;
-        vertex->invQueueIndex = 0;
-        vertex->inv = false;
+const ContractionHierarchy &Graph::getContractionHierarchy() {
+    updateContractionHierarchy();
+    return ch;
+}
+
+/**
+ * @brief Builds the order and the arcs of the customizable contraction hierarchy again if the csr changed since they
+ * were built, and customizes it again if the weights changed since the last customization
+ */
+void Graph::updateCustomizableHierarchy() {
+    updateCSR();
+    if(!cchUpdated) {
+        cch.build(csr);
+        cchUpdated = true;
+        cchCustomized = false;
     }
+    if(cchCustomized) return;
+    cch.customize(csr);
+    cchCustomized = true;
+}
 
-    auto start = findVertex(origin);
-    start->dist = 0;
-    start->heuristicValue = 0;
+/**
+ * @return the customizable contraction hierarchy of the graph, built if the graph changed and customized if the
+ * weights changed since the last time
+ */
+const CustomizableContractionHierarchy &Graph::getCustomizableHierarchy() {
+    updateCustomizableHierarchy();
+    return cch;
+}
+
+/**
+ * @brief Builds the hub labels again if the contraction hierarchy changed since they were built
+ */
+void Graph::updateHubLabels() {
+    updateContractionHierarchy();
+    if(hubLabelsUpdated) return;
+    hubLabels.build(ch);
+    hubLabelsUpdated = true;
+}
+
+/**
+ * @return the hub labels of the graph, built if the graph changed since the last time
+ */
+const HubLabels &Graph::getHubLabels() {
+    updateHubLabels();
+    return hubLabels;
+}
+
+/**
+ * @brief Chooses the landmarks again if the csr changed since they were chosen
+ */
+void Graph::updateLandmarks() {
+    updateCSR();
+    if(landmarksUpdated) return;
+    landmarks.build(csr, numLandmarks, landmarkStrategy);
+    landmarksUpdated = true;
+}
+
+/**
+ * @brief Makes the oriented searches (dijkstraOrientedSearch and dijkstraBidirectional) use the landmarks lower
+ * bound (ALT) together with the euclidean distance. The landmarks are chosen by the next search
+ * @param numLandmarks - number of landmarks, 0 to use only the euclidean distance
+ * @param strategy - how the landmarks are chosen (see Landmarks::build)
+ */
+void Graph::setLandmarks(const int numLandmarks, const Landmarks::Strategy strategy) {
+    this->numLandmarks = numLandmarks;
+    this->landmarkStrategy = strategy;
+    landmarksUpdated = false;
+}
+
+/**
+ * @return the landmarks used by the oriented searches, chosen if the graph changed since the last time
+ */
+const Landmarks &Graph::getLandmarks() {
+    updateLandmarks();
+    return landmarks;
+}
+
+/**
+ * @brief Computes the arc flags again if the csr changed since they were computed
+ */
+void Graph::updateArcFlags() {
+    updateCSR();
+    if(arcFlagsUpdated) return;
+    arcFlags.build(csr, numArcFlagCells, *taskScheduler);
+    arcFlagsUpdated = true;
+}
+
+/**
+ * @brief Sets the number of cells the graph is split into by the arc flags. The flags are computed by the next search
+ * @param numCells - number of cells, at most ArcFlags::maxCells
+ */
+void Graph::setArcFlagCells(const int numCells) {
+    this->numArcFlagCells = numCells;
+    arcFlagsUpdated = false;
+}
+
+/**
+ * @brief Sets the scheduler that runs the parallel work of the graph (shortestPaths, poiMatrix,
+ * floydWarshallShortestPath and the build of the arc flags), the shared one by default. It must outlive the graph, or be replaced before it is gone
+ * @param scheduler - the scheduler
+ */
+void Graph::setScheduler(TaskScheduler &scheduler) {
+    this->taskScheduler = &scheduler;
+}
+
+/**
+ * @return the arc flags used by dijkstraArcFlags, computed if the graph changed since the last time
+ */
+const ArcFlags &Graph::getArcFlags() {
+    updateArcFlags();
+    return arcFlags;
+}
+
+/**************** Dijkstra ************/
+
+/**
+ * @brief Starts a new search in the context (in constant time) and sets the origin as the start of the search
+ * @param context - search context to initialize
+ * @param origin - id of the vertex that represents the origin of the search
+ * @return the index of the origin vertex, -1 if it doesn't exist
+ */
+int Graph::dijkstraInit(SearchContext &context, const int origin) const {
+    context.newSearch(vertexSet.size());
+
+    int start = findVertexIndex(origin);
+    if(start == -1) return -1;
+
+    context.touch(start);
+    context.dist[start] = 0;
+    context.heuristicValue[start] = 0;
 
     return start;
 }
 
 /**
- * @brief Initializes all the camps of the vertexes with the default values related to the invGraph
- * @param dest
- * @return
+ * @brief Sets the destination as the start of the backward search (the inv fields of the context)
+ * @param context - search context already initialized by dijkstraInit
+ * @param dest - id of the vertex that represents the destination of the search
+ * @return the index of the destination vertex, -1 if it doesn't exist
  */
-Vertex* Graph::dijkstraBackwardsInit(const int dest){
-    auto final = findVertex(dest);
-    final->invDist = 0;
-    final->invHeuristicValue = 0;
+int Graph::dijkstraBackwardsInit(SearchContext &context, const int dest) const {
+    int final = findVertexIndex(dest);
+    if(final == -1) return -1;
+
+    context.touch(final);
+    context.invDist[final] = 0;
+    context.invHeuristicValue[final] = 0;
 
     return final;
 }
 
 /**
- * @brief Runs the dijkstra algorithm to find the shortest path to all the vertixes
+ * @brief Runs the dijkstra algorithm to find the shortest path from the central to all the vertixes
+ * The result is kept as the tree of the central, so it is not lost when other searches run, and the trees of the
+ * centrals already used are kept too, so using one of them again (until the graph changes) doesn't search again
  * @param origin - int representing the id of the origin of the graph
  * @return return true if it runned successfully
  */
-
 bool Graph::dijkstraOriginal(const int origin)  {
-    // Initializes the vertex variables based on the origin node
-    Vertex* start = dijkstraInitCentral(origin);
+    updateCSR();
+    int start = findVertexIndex(origin);
+    if(start == -1) return false;
+
+    auto it = centralTrees.find(start);
+    if(it != centralTrees.end()) {
+        centralTree = &it->second;
+        return true;
+    }
 
-    if(start == nullptr) return false;
+    // Initializes the central context based on the origin node
+    SearchContext centralContext;
+    dijkstraInit(centralContext, origin);
 
     // Initialize the priority queue and insert the first vertex
-    MutablePriorityQueue<Vertex> minQueue;
+    SearchQueue minQueue(centralContext.dist, centralContext.queueIndex);
     minQueue.insert(start);
 
     // Iterate over the priority queue until it is empty
     while(!minQueue.empty()) {
         // From the queue extract the vertex that has the minimum distance from the origin point
-        Vertex* min = minQueue.extractMin();
-        min->visited = true;
+        int min = minQueue.extractMin();
+        centralContext.visited[min] = true;
 
         // Iterate over all the edges that start in the min vertex
-        for(Edge edge : min->adj) {
-            auto childVertex = edge.dest;
+        for(int arc = csr.offsets[min]; arc < csr.offsets[min + 1]; arc++) {
+            int childVertex = csr.targets[arc];
+            double weight = csr.weights[arc];
+            centralContext.touch(childVertex);
 
             // For each child of the min vertex, if the distance to the central is bigger then the
             // distance of the new path, then this is the new best path
-            if(childVertex->distCentral > min->distCentral + edge.weight) {
+            if(centralContext.dist[childVertex] > centralContext.dist[min] + weight) {
                 // The distance of the child vertex is equal to the distance from the start point to the father vertex
                 // plus the distance to from the father vertex to the child (denoted as the weight of the edge that connects them)
-                childVertex->distCentral = min->distCentral + edge.weight;
-                childVertex->pathCentral = min;
-                childVertex->edgePathCentral = edge;
+                centralContext.dist[childVertex] = centralContext.dist[min] + weight;
+                centralContext.path[childVertex] = min;
+                centralContext.edgePath[childVertex] = arc;
 
                 // if childVertex is not in queue, insert it, otherwise, update the queue with the new path
-                if(childVertex->queueIndex == 0) minQueue.insert(childVertex);
+                if(centralContext.queueIndex[childVertex] == 0) minQueue.insert(childVertex);
                 else minQueue.decreaseKey(childVertex);
             }
         }
 
         // Since our graph is bidirectional we iterate over all the edges that end in the min vertex
-        for(Edge edge : min->invAdj) {
-            Vertex* fatherVertex = edge.origin;
+        for(int arc = csr.invOffsets[min]; arc < csr.invOffsets[min + 1]; arc++) {
+            int fatherVertex = csr.invTargets[arc];
+            double weight = csr.invWeights[arc];
+            centralContext.touch(fatherVertex);
 
             // For each fatherVertex of the min vertex, if the distance to the central is bigger then the
             // distance of the new path, then this is the new best path
-            if(fatherVertex->distCentral > min->distCentral + edge.weight) {
-                fatherVertex->distCentral = min->distCentral + edge.weight;
-                fatherVertex->pathCentral = min;
-                fatherVertex->edgePathCentral = edge;
+            if(centralContext.dist[fatherVertex] > centralContext.dist[min] + weight) {
+                centralContext.dist[fatherVertex] = centralContext.dist[min] + weight;
+                centralContext.path[fatherVertex] = min;
+                centralContext.edgePath[fatherVertex] = csr.invArcs[arc];
 
                 // if fatherVertex is not in queue, insert it, otherwise, update the queue with the new path
-                if(fatherVertex->queueIndex == 0) minQueue.insert(fatherVertex);
+                if(centralContext.queueIndex[fatherVertex] == 0) minQueue.insert(fatherVertex);
                 else minQueue.decreaseKey(fatherVertex);
             }
         }
     }
 
+    ShortestPathTree &tree = centralTrees[start];
+    tree.build(centralContext, start, csr.getNumArcs(), getChecksum());
+    centralTree = &tree;
     return true;
 }
 
 /**
- * @brief Runs dijkstra algorithm to find the best path between two points
+ * @brief Makes the tree saved in a file by saveCentralTree the tree of the central, instead of running
+ * dijkstraOriginal. The file is mapped into memory and checked, which takes linear time but no search
+ * @param file - path of the file
+ * @param origin - id of the central
+ * @return - true if the tree of the central was already kept, or the file has it for this same graph
+ */
+bool Graph::loadCentralTree(const string &file, const int origin) {
+    updateCSR();
+    int start = findVertexIndex(origin);
+    if(start == -1) return false;
+
+    auto it = centralTrees.find(start);
+    if(it != centralTrees.end()) {
+        centralTree = &it->second;
+        return true;
+    }
+
+    ShortestPathTree &tree = centralTrees[start];
+    if(!tree.load(file, start, vertexSet.size(), csr.getNumArcs(), getChecksum())) {
+        centralTrees.erase(start);
+        return false;
+    }
+    centralTree = &tree;
+    return true;
+}
+
+/**
+ * @brief Saves the tree of the central to a file, together with the checksum of the graph
+ * @param file - path of the file
+ * @return - true if there is a tree and the file was written
+ */
+bool Graph::saveCentralTree(const string &file) const {
+    return centralTree != nullptr && centralTree->save(file);
+}
+
+/**
+ * @brief Runs dijkstra algorithm to find the best path between two points, using the graph's own search context
  * @param origin - integer representing the id of starting node
  * @param dest - integer representing the id of destination node
  * @param processedEdges - set that stores the id of th edges that are processed
  * @return - true if it runs successfully
  */
 bool Graph::dijkstra(const int origin, const int dest, unordered_set<int> &processedEdges)  {
-    // Initialize all the vertex and find the origin and destination
-    auto start = dijkstraInit(origin);
-    auto final = findVertex(dest);
+    updateCSR();
+    return dijkstra(defaultContext, origin, dest, processedEdges);
+}
+
+/**
+ * @brief Runs dijkstra algorithm to find the best path between two points
+ * @param context - search context where the distances and paths are saved
+ * @param origin - integer representing the id of starting node
+ * @param dest - integer representing the id of destination node
+ * @param processedEdges - set that stores the id of th edges that are processed
+ * @return - true if it runs successfully
+ */
+bool Graph::dijkstra(SearchContext &context, const int origin, const int dest, unordered_set<int> &processedEdges) const {
+    // Initialize the context and find the origin and destination
+    auto start = dijkstraInit(context, origin);
+    auto final = findVertexIndex(dest);
 	processedEdges.clear();
 
     // If it can't find the start vertex or the final vertex then it can't execute the algorithm
-    if(start == nullptr || final == nullptr) return false;
+    if(start == -1 || final == -1 || !csrUpdated) return false;
 
     // Initialize the priority queue and insert the first vertex
-    MutablePriorityQueue<Vertex> minQueue;
+    SearchQueue minQueue(context.dist, context.queueIndex);
     minQueue.insert(start);
 
     // Iterate over the priority queue until it is empty or we find the final vertex
     while(!minQueue.empty()) {
         // From the queue extract the vertex that has the minimum distance from the origin point
-        Vertex* min = minQueue.extractMin();
-        min->visited = true;
+        int min = minQueue.extractMin();
+        context.visited[min] = true;
 
         // The algorithm ends when we dequeue the final vertex
         if(min == final)
             break;
 
         // Iterate over all the edges that start in the min vertex
-        for(auto edge : min->adj) {
-            auto childVertex = edge.dest;
+        for(int arc = csr.offsets[min]; arc < csr.offsets[min + 1]; arc++) {
+            int childVertex = csr.targets[arc];
+            double weight = csr.weights[arc];
+            context.touch(childVertex);
 
             // If the childVertex as already been dequeued then we can skip it
-            if(childVertex->visited) continue;
+            if(context.visited[childVertex]) continue;
 
             // Save the edge that has been processed to be drawn later
-            processedEdges.insert(edge.getId());
+            processedEdges.insert(csr.edgeIds[arc]);
 
             // Relax the Child Vertex
             // If the distance to the start vertex is bigger then the distance of the new path,
             // then this is the new best path
-            if(childVertex->dist > min->dist + edge.weight) {
+            if(context.dist[childVertex] > context.dist[min] + weight) {
                 // The distance of the child vertex is equal to the distance from the start point to the father vertex
                 // plus the distance from the father vertex to the child (denoted as the weight of the edge that connects them)
-                childVertex->dist = min->dist + edge.weight;
+                context.dist[childVertex] = context.dist[min] + weight;
 
-                // The path is the vertex that leads to the Child Vertex by taking the edge saved in edgePath
-                childVertex->path = min;
-                childVertex->edgePath = edge;
+                // The path is the vertex that leads to the Child Vertex by taking the arc saved in edgePath
+                context.path[childVertex] = min;
+                context.edgePath[childVertex] = arc;
 
                 // if childVertex is not in queue, insert it, otherwise, update the queue with the new path
-                if(childVertex->queueIndex == 0) minQueue.insert(childVertex);
+                if(context.queueIndex[childVertex] == 0) minQueue.insert(childVertex);
                 else minQueue.decreaseKey(childVertex);
             }
         }
 
         // Since our graph is bidirectional we iterate over all the edges that end in the min vertex
-        for(auto edge : min->invAdj) {
-            auto FatherVertex = edge.origin;
+        for(int arc = csr.invOffsets[min]; arc < csr.invOffsets[min + 1]; arc++) {
+            int FatherVertex = csr.invTargets[arc];
+            double weight = csr.invWeights[arc];
+            context.touch(FatherVertex);
+
             // If the Father Vertex as already been dequeued then we can skip it
-            if(FatherVertex->visited) continue;
+            if(context.visited[FatherVertex]) continue;
 
             // Save the edge that has been processed to be drawn later
-            processedEdges.insert(edge.getId());
+            processedEdges.insert(csr.invEdgeIds[arc]);
 
             // Relax the Father Vertex
             // If the distance to the start vertex is bigger then the distance of the new path,
             // then this is the new best path
-            if(FatherVertex->dist > min->dist + edge.weight) {
+            if(context.dist[FatherVertex] > context.dist[min] + weight) {
                 // The distance of the father vertex is equal to the distance from the start point to the child vertex
                 // plus the distance from the father vertex to the child (denoted as the weight of the edge that connects them)
-                FatherVertex->dist = min->dist + edge.weight;
+                context.dist[FatherVertex] = context.dist[min] + weight;
 
-                // The path is the vertex that leads to the Father Vertex by taking the edge saved in edgePath
-                FatherVertex->path = min;
-                FatherVertex->edgePath = edge;
+                // The path is the vertex that leads to the Father Vertex by taking the arc saved in edgePath
+                context.path[FatherVertex] = min;
+                context.edgePath[FatherVertex] = csr.invArcs[arc];
 
                 // if FatherVertex is not in queue, insert it, otherwise, update the queue with the new path
-                if(FatherVertex->queueIndex == 0) minQueue.insert(FatherVertex);
+                if(context.queueIndex[FatherVertex] == 0) minQueue.insert(FatherVertex);
                 else minQueue.decreaseKey(FatherVertex);
             }
         }
@@ -409,34 +1084,144 @@ bool Graph::dijkstra(const int origin, const int dest, unordered_set<int> &proce
     return true;
 }
 
+/**
+ * @brief Runs dijkstra from the start vertex until every target is settled (or there is nothing else to reach)
+ * @param context - search context already initialized by dijkstraInit
+ * @param start - index of the vertex where the search starts
+ * @param targets - indexes of the vertexes the search must reach
+ */
+void Graph::oneToManySearch(SearchContext &context, const int start, const vector<int> &targets) const {
+    // The targets that weren't settled yet, the search ends when there are none left
+    unordered_set<int> remaining(targets.begin(), targets.end());
+
+    SearchQueue minQueue(context.dist, context.queueIndex);
+    minQueue.insert(start);
+
+    while(!minQueue.empty() && !remaining.empty()) {
+        int min = minQueue.extractMin();
+        context.visited[min] = true;
+        remaining.erase(min);
+
+        // Relax the vertexes reached by the edges that start in the min vertex
+        for(int arc = csr.offsets[min]; arc < csr.offsets[min + 1]; arc++) {
+            int childVertex = csr.targets[arc];
+            context.touch(childVertex);
+            if(context.visited[childVertex] || context.dist[childVertex] <= context.dist[min] + csr.weights[arc]) continue;
+
+            context.dist[childVertex] = context.dist[min] + csr.weights[arc];
+            context.path[childVertex] = min;
+            context.edgePath[childVertex] = arc;
+            if(context.queueIndex[childVertex] == 0) minQueue.insert(childVertex);
+            else minQueue.decreaseKey(childVertex);
+        }
+
+        // And the ones reached by the edges that end in it, since our graph is bidirectional
+        for(int arc = csr.invOffsets[min]; arc < csr.invOffsets[min + 1]; arc++) {
+            int fatherVertex = csr.invTargets[arc];
+            context.touch(fatherVertex);
+            if(context.visited[fatherVertex] || context.dist[fatherVertex] <= context.dist[min] + csr.invWeights[arc]) continue;
+
+            context.dist[fatherVertex] = context.dist[min] + csr.invWeights[arc];
+            context.path[fatherVertex] = min;
+            context.edgePath[fatherVertex] = csr.invArcs[arc];
+            if(context.queueIndex[fatherVertex] == 0) minQueue.insert(fatherVertex);
+            else minQueue.decreaseKey(fatherVertex);
+        }
+    }
+}
+
+/**
+ * @brief Runs dijkstra from one vertex to several, using the graph's own search context
+ * @param origin - integer representing the id of starting node
+ * @param targets - ids of the vertexes the paths end in
+ * @param distances - filled with the distance to each target (infinite if it can't be reached)
+ * @return - true if every vertex exists
+ */
+bool Graph::dijkstraOneToMany(const int origin, const vector<int> &targets, vector<double> &distances) {
+    updateCSR();
+    return dijkstraOneToMany(defaultContext, origin, targets, distances);
+}
+
+/**
+ * @brief Runs dijkstra from one vertex to several in a single search, which ends as soon as every target is settled.
+ * The path to each target can then be read with getPathTo
+ * @param context - search context where the distances and paths are saved
+ * @param origin - integer representing the id of starting node
+ * @param targets - ids of the vertexes the paths end in
+ * @param distances - filled with the distance to each target (infinite if it can't be reached)
+ * @return - true if every vertex exists
+ */
+bool Graph::dijkstraOneToMany(SearchContext &context, const int origin, const vector<int> &targets, vector<double> &distances) const {
+    distances.clear();
+    int start = dijkstraInit(context, origin);
+    if(start == -1 || !csrUpdated) return false;
+
+    vector<int> targetIndexes;
+    for(int id : targets) {
+        targetIndexes.push_back(findVertexIndex(id));
+        if(targetIndexes.back() == -1) return false;
+    }
+
+    oneToManySearch(context, start, targetIndexes);
+    for(int target : targetIndexes)
+        distances.push_back(context.getVisited(target) ? context.dist[target] : numeric_limits<double>::infinity());
+
+    return true;
+}
+
+/**
+ * @brief Builds the Edge that corresponds to an arc of the csr
+ * @param arc - index of the arc in the outgoing csr arrays
+ * @param vertex - index of the vertex that was reached through the arc
+ * @param previous - index of the vertex the arc was taken from
+ * @return the edge, with its origin and destination in the direction it was stored in the graph
+ */
+Edge Graph::getArcEdge(const int arc, const int vertex, const int previous) const {
+    // The searches also walk the arcs backwards, in that case the vertex reached is the origin of the edge
+    if(csr.targets[arc] == vertex)
+        return Edge(csr.edgeIds[arc], vertexSet[vertex], vertexSet[previous], csr.weights[arc]);
+    return Edge(csr.edgeIds[arc], vertexSet[previous], vertexSet[vertex], csr.weights[arc]);
+}
+
 /**
  * @brief Saves the edges that make the path from the a vertex to the other into a vector
- * after running one of the dijkstra algorithms
+ * after running one of the dijkstra algorithms with the graph's own search context
  * @param dest - integer representing the id of the vertex where the path ends
  * @param edges - vector of Edges where we save the edges that belong to the path
  * @return integer representing the distance from the start vertex to the destination
  */
 int Graph::getPathTo(const int dest, vector<Edge> &edges) const {
+    return getPathTo(defaultContext, dest, edges);
+}
+
+/**
+ * @brief Saves the edges that make the path from the a vertex to the other into a vector
+ * after running one of the dijkstra algorithms
+ * @param context - search context used by the algorithm
+ * @param dest - integer representing the id of the vertex where the path ends
+ * @param edges - vector of Edges where we save the edges that belong to the path
+ * @return integer representing the distance from the start vertex to the destination
+ */
+int Graph::getPathTo(const SearchContext &context, const int dest, vector<Edge> &edges) const {
     // Searches for the destination vertex
-    Vertex *destination = findVertex(dest);
+    int destination = findVertexIndex(dest);
 
     // If we can't find the destination vertex or if the destination has no path that goes to it
     // Then we can run the algorithm
-    if(destination == nullptr || (destination->path == nullptr && destination->invPath == nullptr))
+    if(destination == -1 || !context.isTouched(destination) || (context.path[destination] == -1 && context.invPath[destination] == -1))
         return false;
 
     // The total distance of the trip is the attribute dist that we calculate in each of the algorithm
-    int dist = destination->dist;
+    int dist = context.dist[destination];
 
     // Iterate until the destination has no vertex that lead to it
     // This means that it is the start vertex
-    while(destination->path != nullptr) {
+    while(context.path[destination] != -1) {
         // Save the edge that leads to the previous vertex into edges
-        edges.push_back(destination->getEdgePath());
+        edges.push_back(getArcEdge(context.edgePath[destination], destination, context.path[destination]));
 
         // Set destination equal to the vertex that leads to him
-        destination = destination->path;
-
+        destination = context.path[destination];
     }
 
     // Since we start from the end, rather then the beginning, we must reverse the vector so it has the correct order
@@ -446,31 +1231,31 @@ int Graph::getPathTo(const int dest, vector<Edge> &edges) const {
 }
 
 /**
- * @brief Saves the edges that make the path from the a vertex to the central after running the dijkstraOriginal algorithms (line 255)
+ * @brief Saves the edges that make the path from the a vertex to the central after running the dijkstraOriginal algorithms
  * @param dest - integer representing the id of the vertex that we want to calculate the distance to the central
  * @param edges - vector of Edges where we save the edges that belong to the path to the central
  * @return integer representing the distance from the central to the destination
  */
 int Graph::getPathFromCentralTo(const int dest, vector<Edge> &edges) const {
     // Searches for the destination vertex
-    Vertex *destination = findVertex(dest);
+    int destination = findVertexIndex(dest);
 
     // If we can't find the destination vertex or if the destination has no path that goes to it
     // Then we can run the algorithm
-    if(destination == nullptr || destination->pathCentral == nullptr)
+    if(destination == -1 || centralTree == nullptr || destination >= centralTree->getNumVertex() || centralTree->getPath(destination) == -1)
         return false;
 
-    // The total distance to the central equal to the attribute distCentral that we calculate in dijsktraOriginal (line 255)
-    int dist = destination->distCentral;
+    // The total distance to the central equal to the distance calculated in dijsktraOriginal
+    int dist = centralTree->getDist(destination);
 
     // Iterate until the destination has no vertex that lead to it
     // This means that it is the central vertex
-    while(destination->pathCentral != nullptr) {
+    while(centralTree->getPath(destination) != -1) {
         // Save the edge that leads to the previous vertex into edges
-        edges.push_back(destination->edgePathCentral);
+        edges.push_back(getArcEdge(centralTree->getEdgePath(destination), destination, centralTree->getPath(destination)));
 
         // Set destination equal to the vertex that leads to him
-        destination = destination->pathCentral;
+        destination = centralTree->getPath(destination);
     }
 
     // Since we start from the end, rather then the beginning, we must reverse the vector so it has the correct order
@@ -487,18 +1272,58 @@ int Graph::getPathFromCentralTo(const int dest, vector<Edge> &edges) const {
  * @param dest - integer representing the id of the vertex that is the destination of the path
  * @return integer representing the euclidian distance from the origin vertex to the destination vertex
  */
-double Graph::heuristicDistance(Vertex *origin, Vertex *dest) {
+double Graph::heuristicDistance(Vertex *origin, Vertex *dest) const {
     return origin->getPosition().euclideanDistance(dest->getPosition());
 }
 
+/**
+ * @brief Heuristic of the oriented searches: the euclidean distance, improved by the landmarks lower bound (ALT)
+ * when the graph has landmarks
+ * @param origin - vertex that is the origin of the path
+ * @param dest - vertex that is the destination of the path
+ * @return lower bound of the distance from the origin vertex to the destination vertex
+ */
+double Graph::landmarkDistance(Vertex *origin, Vertex *dest) const {
+    return landmarkDistance(origin->index, dest->index, heuristicDistance(origin, dest));
+}
+
+/**
+ * @brief Same as landmarkDistance for the searches, which compute the euclidean distances of a whole list of
+ * neighbours at once (CSRGraph::arcDistances)
+ * @param vertex - index of the vertex that is the origin of the path
+ * @param dest - index of the vertex that is the destination of the path
+ * @param distance - euclidean distance between the vertexes
+ * @return lower bound of the distance from the origin vertex to the destination vertex
+ */
+double Graph::landmarkDistance(const int vertex, const int dest, const double distance) const {
+    // Both are lower bounds of the real distance, so the biggest one is the best estimate
+    if(numLandmarks > 0 && landmarksUpdated)
+        return max(distance, landmarks.lowerBound(vertex, dest));
+    return distance;
+}
+
+/**
+ * @brief Optimization of the regular dijkstra algorithm by using an heuristic function to aid the search,
+ * using the graph's own search context
+ * @param origin - integer representing the id of starting node
+ * @param dest - integer representing the id of destination node
+ * @param processedEdges - set that stores the id of th edges that are processed
+ * @return - true if it runs successfully
+ */
+bool Graph::dijkstraOrientedSearch(const int origin, const int dest, unordered_set<int> &processedEdges) {
+    updateLandmarks();
+    return dijkstraOrientedSearch(defaultContext, origin, dest, processedEdges);
+}
+
 /**
  * @brief Optimization of the regular dijkstra algorithm by using an heuristic function to aid the search
+ * @param context - search context where the distances and paths are saved
  * @param origin - integer representing the id of starting node
  * @param dest - integer representing the id of destination node
  * @param processedEdges - set that stores the id of th edges that are processed
  * @return - true if it runs successfully
  */
-bool Graph::dijkstraOrientedSearch(const int origin, const int dest, unordered_set<int> &processedEdges) 
+bool Graph::dijkstraOrientedSearch(SearchContext &context, const int origin, const int dest, unordered_set<int> &processedEdges) const
 {
     /*
      * Some notation to help the understanding of the comments of this algorithm
@@ -509,85 +1334,99 @@ bool Graph::dijkstraOrientedSearch(const int origin, const int dest, unordered_s
      * v to the final vertex. This is what it is used when selecting the minimum vertex of the queue.
      */
 
-    // Initializes the vertex variables based on the origin node and finds the final vertex
-    Vertex* start = dijkstraInit(origin);
-    Vertex* final = findVertex(dest);
+    // Initializes the context based on the origin node and finds the final vertex
+    int start = dijkstraInit(context, origin);
+    int final = findVertexIndex(dest);
     processedEdges.clear();
 
     // If it can't find the start vertex or the final vertex then it can't execute the algorithm
-    if(start == nullptr || final == nullptr) return false;
+    if(start == -1 || final == -1 || !csrUpdated) return false;
 
-    int i = 0;
-    MutablePriorityQueue<Vertex> minQueue;
+    SearchQueue minQueue(context.heuristicValue, context.queueIndex);
     minQueue.insert(start); // Initialize the priority queue and insert the start vertex
 
+    // H() of the neighbours of the min vertex, computed for the whole list at once from the coordinates of the final vertex
+    double finalX = csr.xs[final], finalY = csr.ys[final];
+    vector<double> heuristics;
+
     // Iterate over the priority queue until it is empty or we find the final vertex
     while(!minQueue.empty()) {
         // From the queue extract the vertex that has the minimum F()
-        Vertex* min = minQueue.extractMin();
-        min->visited = true;
+        int min = minQueue.extractMin();
+        context.visited[min] = true;
 
-        if(min->getId() == final->getId())
+        if(min == final)
             break; // The algorithm ends when we dequeue the final vertex
 
         // Iterate over all the edges that start in the min vertex
-        for(Edge edge : min->adj) {
-            Vertex* childVertex = edge.dest;
-            int weight = edge.weight;
+        int first = csr.offsets[min], last = csr.offsets[min + 1];
+        if(heuristics.size() < (size_t) (last - first)) heuristics.resize(last - first);
+        csr.arcDistances(true, first, last, finalX, finalY, heuristics.data());
+        for(int arc = first; arc < last; arc++) {
+            int childVertex = csr.targets[arc];
+            double weight = csr.weights[arc];
+            if(weight == numeric_limits<double>::infinity()) continue;     // closed by setEdgeWeights
+            context.touch(childVertex);
 
             // If the childVertex as already been dequeued then we can skip it
-            if(childVertex->visited) continue;
+            if(context.visited[childVertex]) continue;
 
             // Save the edge that has been processed to be drawn later
-            processedEdges.insert(edge.getId());
+            processedEdges.insert(csr.edgeIds[arc]);
 
             // Relax the Child Vertex
             // If the distance to the start node is bigger then the distance of the new path,
             // then this is the new best path
-            if(min->dist + weight < childVertex->dist) {
-                // The path is the vertex that leads to the Child Vertex by taking the edge saved in edgePath
-                childVertex->path = min;
-                childVertex->edgePath = edge;
+            if(context.dist[min] + weight < context.dist[childVertex]) {
+                // The path is the vertex that leads to the Child Vertex by taking the arc saved in edgePath
+                context.path[childVertex] = min;
+                context.edgePath[childVertex] = arc;
 
                 // Recalculate G(childVertex)
-                childVertex->dist = min->dist + weight;
+                context.dist[childVertex] = context.dist[min] + weight;
 
                 // Recalculate F(childVertex)
-                childVertex->heuristicValue = childVertex->dist + heuristicDistance(childVertex, final);
+                context.heuristicValue[childVertex] = context.dist[childVertex] + landmarkDistance(childVertex, final, heuristics[arc - first]);
 
                 // if childVertex is not in queue, insert it, otherwise, update the queue with the new path
-                if(childVertex->queueIndex == 0) minQueue.insert(childVertex);
+                if(context.queueIndex[childVertex] == 0) minQueue.insert(childVertex);
                 else minQueue.decreaseKey(childVertex);
             }
         }
 
         // Since our graph is bidirectional we iterate over all the edges that end in the min vertex
-        for(Edge edge : min->invAdj) {
-            Vertex* fatherVertex = edge.origin;
-            int weight = edge.weight;
+        first = csr.invOffsets[min];
+        last = csr.invOffsets[min + 1];
+        if(heuristics.size() < (size_t) (last - first)) heuristics.resize(last - first);
+        csr.arcDistances(false, first, last, finalX, finalY, heuristics.data());
+        for(int arc = first; arc < last; arc++) {
+            int fatherVertex = csr.invTargets[arc];
+            double weight = csr.invWeights[arc];
+            if(weight == numeric_limits<double>::infinity()) continue;     // closed by setEdgeWeights
+            context.touch(fatherVertex);
 
             // If the Father Vertex as already been dequeued then we can skip it
-            if(fatherVertex->visited) continue;
+            if(context.visited[fatherVertex]) continue;
 
             // Save the edge that has been processed to be drawn later
-            processedEdges.insert(edge.getId());
+            processedEdges.insert(csr.invEdgeIds[arc]);
 
             // Relax the Father Vertex
             // If the distance to the central is bigger then the distance of the new path,
             // then this is the new best path
-            if(min->dist + weight  < fatherVertex->dist) {
-                // The path is the vertex that leads to the Child Vertex by taking the edge saved in edgePath
-                fatherVertex->path = min;
-                fatherVertex->edgePath = edge;
+            if(context.dist[min] + weight  < context.dist[fatherVertex]) {
+                // The path is the vertex that leads to the Child Vertex by taking the arc saved in edgePath
+                context.path[fatherVertex] = min;
+                context.edgePath[fatherVertex] = csr.invArcs[arc];
 
                 // Recalculate G(fatherVertex)
-                fatherVertex->dist = min->dist + weight;
+                context.dist[fatherVertex] = context.dist[min] + weight;
 
                 // Recalculate F(fatherVertex)
-                fatherVertex->heuristicValue = fatherVertex->dist + heuristicDistance(fatherVertex, final);
+                context.heuristicValue[fatherVertex] = context.dist[fatherVertex] + landmarkDistance(fatherVertex, final, heuristics[arc - first]);
 
                 // if fatherVertex is not in queue, insert it, otherwise, update the queue with the new path
-                if(fatherVertex->queueIndex == 0) minQueue.insert(fatherVertex);
+                if(context.queueIndex[fatherVertex] == 0) minQueue.insert(fatherVertex);
                 else minQueue.decreaseKey(fatherVertex);
             }
         }
@@ -596,340 +1435,664 @@ bool Graph::dijkstraOrientedSearch(const int origin, const int dest, unordered_s
     return true;
 }
 
-// Upgrades the optimization using a* with bidirectional search
-bool Graph::dijkstraBidirectional(const int origin, const int dest, unordered_set<int> &processedEdges, unordered_set<int> &processedEdgesInv) 
+// Upgrades the optimization using a* with bidirectional search, using the graph's own search context
+bool Graph::dijkstraBidirectional(const int origin, const int dest, unordered_set<int> &processedEdges, unordered_set<int> &processedEdgesInv)
+{
+    updateLandmarks();
+    return dijkstraBidirectional(defaultContext, origin, dest, processedEdges, processedEdgesInv);
+}
+
+/**
+ * @brief Upgrades the optimization using a* with bidirectional search.
+ * Both searches use the same potential with opposite signs (half of the difference between the heuristic distances
+ * to the final vertex and to the start vertex), so an arc looks equally long to both of them. Every time a search
+ * reaches a vertex the other one already reached, there is a path through it, and mu keeps the shortest one.
+ * The searches stop when the smallest keys of both queues add up to mu, since no path left can be shorter
+ * @param context - search context where the distances and paths are saved
+ * @param origin - integer representing the id of starting node
+ * @param dest - integer representing the id of destination node
+ * @param processedEdges - set that stores the id of the edges processed by the forward search
+ * @param processedEdgesInv - set that stores the id of the edges processed by the backward search
+ * @return - true if there is a path between the vertexes
+ */
+bool Graph::dijkstraBidirectional(SearchContext &context, const int origin, const int dest, unordered_set<int> &processedEdges, unordered_set<int> &processedEdgesInv) const
 {
     /*
      * Some notation to help the understanding of the comments of this algorithm
      * G(Vertex* v) --> distance from v to the start vertex (or final vertex if it is used in the backward search),
      * that is, cumulative sum of the weights of the edges that go from the start vertex to v;
-     * H(Vertex* v) --> heuristic distance from v to the final vertex (or the start vertex if it is used in the backward search);
-     * F(Vertex* v) --> G(v) + H(v), sum of the real distance from the start to v and the speculative distance from
-     * v to the final vertex. This is what it is used when selecting the minimum vertex of the queue.
-     * All the vertex attributes that have "inv" in the name represent the same thing as the ones that don't have it,
+     * P(Vertex* v) --> potential of v: (H(v, final) - H(v, start)) / 2 in the forward search and the opposite in the
+     * backward search, where H is the heuristic distance between two vertexes;
+     * F(Vertex* v) --> G(v) + P(v). This is what it is used when selecting the minimum vertex of the queue.
+     * All the context fields that have "inv" in the name represent the same thing as the ones that don't have it,
      * the only difference is that they are used as if we were travelling to the inverse graph. This lets us not have to
      * invert the graph itself.
      */
 
-    // Initializes the vertex variables based on the origin node and finds the final vertex (while setting the correct
+    // Initializes the context based on the origin node and finds the final vertex (while setting the correct
     // inv values to it)
-    auto start = dijkstraInit(origin);
-    auto final = dijkstraBackwardsInit(dest);
+    auto start = dijkstraInit(context, origin);
+    auto final = dijkstraBackwardsInit(context, dest);
 
     // Make sure the sets don't have anything in them
     processedEdges.clear();
     processedEdgesInv.clear();
 
     // If it can't find the start vertex or the final vertex then it can't execute the algorithm
-    if(start == nullptr || final == nullptr) return false;
+    if(start == -1 || final == -1 || !csrUpdated) return false;
+
+    // Potential of a vertex in the forward search (the backward search uses the opposite), from the euclidean
+    // distances of the vertex to the final and to the start vertexes
+    auto potential = [&](const int vertex, const double toFinal, const double toStart) {
+        return (landmarkDistance(vertex, final, toFinal) - landmarkDistance(vertex, start, toStart)) / 2;
+    };
+    double finalX = csr.xs[final], finalY = csr.ys[final];
+    double startX = csr.xs[start], startY = csr.ys[start];
+    double startFinal = csr.distance(start, finalX, finalY);
+    context.heuristicValue[start] = potential(start, startFinal, 0);
+    context.invHeuristicValue[final] = -potential(final, 0, startFinal);
+
+    // Euclidean distances of the neighbours of the min vertex to the final and to the start vertexes,
+    // computed for the whole list at once
+    vector<double> toFinal, toStart;
+
+    // Initialize the forward and backward priority queues, ordered by F()
+    SearchQueue forwardMinQueue(context.heuristicValue, context.queueIndex);
+    forwardMinQueue.insert(start);
+    SearchQueue backwardMinQueue(context.invHeuristicValue, context.invQueueIndex);
+    backwardMinQueue.insert(final);
+
+    // Length of the shortest path found so far and the vertex where its two halves meet
+    double mu = start == final ? 0 : numeric_limits<double>::infinity();
+    int middle_vertex = start == final ? start : -1;
+
+    // F() of the last vertex extracted by each search: the keys only grow, so they are lower bounds of the queues
+    double lastKey[2] = {context.heuristicValue[start], context.invHeuristicValue[final]};
+    bool done = false;
+
+    while(!done) {
+        for(int direction = 0; direction < 2 && !done; direction++) {
+            bool forward = direction == 0;
+            SearchQueue &queue = forward ? forwardMinQueue : backwardMinQueue;
+            vector<double> &dist = forward ? context.dist : context.invDist;
+            vector<double> &otherDist = forward ? context.invDist : context.dist;
+            vector<double> &heuristicValue = forward ? context.heuristicValue : context.invHeuristicValue;
+            vector<int> &path = forward ? context.path : context.invPath;
+            vector<int> &edgePath = forward ? context.edgePath : context.invEdgePath;
+            vector<char> &visited = forward ? context.visited : context.invVisited;
+            vector<int> &queueIndex = forward ? context.queueIndex : context.invQueueIndex;
+            unordered_set<int> &edges = forward ? processedEdges : processedEdgesInv;
+
+            // If one of the queues is empty, every path was already seen by the other search
+            if(queue.empty()) {
+                done = true;
+                break;
+            }
 
-    // Initialize the forward priority queue
-    MutablePriorityQueue<Vertex> forwardMinQueue;
-    forwardMinQueue.setInv(false); // Let the queue know that it is the forward queue
-    forwardMinQueue.insert(start); // Add the start vertex to it
+            // Extract the vertex with the minimum F() from the queue
+            int min = queue.extractMin();
+            lastKey[direction] = heuristicValue[min];
 
-    MutablePriorityQueue<Vertex> backwardMinQueue; // Initialize the backward priority queue
-    backwardMinQueue.setInv(true);  // Let the queue know that it is the backward queue
-    backwardMinQueue.insert(final); // Add the final vertex to it
+            // No path left can be shorter than mu
+            if(lastKey[0] + lastKey[1] >= mu) {
+                done = true;
+                break;
+            }
+            visited[min] = true;
+
+            // Since our graph is bidirectional both searches follow the edges that start and that end in the vertex
+            for(int side = 0; side < 2; side++) {
+                bool outgoing = side == 0;
+                int first = outgoing ? csr.offsets[min] : csr.invOffsets[min];
+                int last = outgoing ? csr.offsets[min + 1] : csr.invOffsets[min + 1];
+                if(toFinal.size() < (size_t) (last - first)) {
+                    toFinal.resize(last - first);
+                    toStart.resize(last - first);
+                }
+                csr.arcDistances(outgoing, first, last, finalX, finalY, toFinal.data());
+                csr.arcDistances(outgoing, first, last, startX, startY, toStart.data());
+
+                for(int arc = first; arc < last; arc++) {
+                    int next = outgoing ? csr.targets[arc] : csr.invTargets[arc];
+                    double weight = outgoing ? csr.weights[arc] : csr.invWeights[arc];
+                    context.touch(next);
+
+                    // If the vertex as already been dequeued then we can skip it
+                    if(visited[next]) continue;
+
+                    // Save the edge that has been processed to be drawn later
+                    edges.insert(outgoing ? csr.edgeIds[arc] : csr.invEdgeIds[arc]);
+
+                    // Relax the vertex: if the distance of the new path is smaller, then this is the new best path
+                    if(dist[min] + weight < dist[next]) {
+                        dist[next] = dist[min] + weight;
+                        path[next] = min;
+                        edgePath[next] = outgoing ? arc : csr.invArcs[arc];
+                        double nextPotential = potential(next, toFinal[arc - first], toStart[arc - first]);
+                        heuristicValue[next] = dist[next] + (forward ? nextPotential : -nextPotential);
+
+                        // if the vertex is not in queue, insert it, otherwise, update the queue with the new path
+                        if(queueIndex[next] == 0) queue.insert(next);
+                        else queue.decreaseKey(next);
+                    }
+
+                    // The other search already reached the vertex, so there is a path through it
+                    if(otherDist[next] != infinite && dist[next] + otherDist[next] < mu) {
+                        mu = dist[next] + otherDist[next];
+                        middle_vertex = next;
+                    }
+                }
+            }
+        }
+    }
 
-    // Vectors representing a closed list of the vertexes that have been processed in each search
-    vector<int> processed;
-    vector<int> backward_processed;
+    // If the searches never met there is no path between the vertexes
+    if(middle_vertex == -1) return false;
 
-    // Initialize the forward search and backward search minimum vertex
-    Vertex *forwardMin = nullptr;
-    Vertex *backwardMin = nullptr;
-    Vertex *middle_vertex = nullptr; // Initialize the vertex where both searches will meet
+    // With edges of length 0 both halves of the path can share vertexes, and then the path is as short through
+    // the last vertex of the backward half that is also in the forward half
+    unordered_set<int> forwardHalf;
+    for(int vertex = middle_vertex; vertex != -1; vertex = context.path[vertex])
+        forwardHalf.insert(vertex);
+    for(int vertex = middle_vertex; vertex != -1; vertex = context.invPath[vertex])
+        if(forwardHalf.count(vertex)) middle_vertex = vertex;
 
-    // Iterate over both priority queues until one of them is empty or when they process the same vertex
-    while(!forwardMinQueue.empty() && !backwardMinQueue.empty()) {
-        /*
-         * Forward Search
-         */
+    // Convert the invPath and invEdgePath to path and edgePath to be used in getPathTo
+    while(context.invPath[middle_vertex] != -1) {
+        // The invPath is the vertex that leads to midle_vertex from the backward search
+        // So we set path, edgePath, and dist of that vertex with the middle_vertex values
+        int previous = context.invPath[middle_vertex];
+        context.path[previous] = middle_vertex;
+        context.edgePath[previous] = context.invEdgePath[middle_vertex];
+        context.dist[previous] = context.dist[middle_vertex] + csr.weights[context.invEdgePath[middle_vertex]];
+        middle_vertex = previous;
+    }
 
-        // Extract the vertex with the minimum F() from the forward queue
-        forwardMin = forwardMinQueue.extractMin();
-        forwardMin->visited = true;
+    return true;
+}
 
-        // Add it to the processed vector
-        processed.push_back(forwardMin->id);
+/**************** Arc Flags ************/
 
-        // Iterate over all the edges that start in the vertex
-        for(Edge edge : forwardMin->adj) {
-            Vertex* childVertex = edge.dest;
-            int weight = edge.weight;
+/**
+ * @brief Finds the best path between two points with dijkstra, following only the arcs flagged as leading to the
+ * cell of the destination (the flags are computed the first time they are needed), using the graph's own search context
+ * @param origin - integer representing the id of starting node
+ * @param dest - integer representing the id of destination node
+ * @param processedEdges - set that stores the id of th edges that are processed
+ * @return - true if it runs successfully
+ */
+bool Graph::dijkstraArcFlags(const int origin, const int dest, unordered_set<int> &processedEdges) {
+    updateArcFlags();
+    return dijkstraArcFlags(defaultContext, origin, dest, processedEdges);
+}
 
-            // If the childVertex as already been dequeued then we can skip it
-            if(childVertex->visited) continue;
+/**
+ * @brief Finds the best path between two points with dijkstra, following only the arcs flagged as leading to the
+ * cell of the destination. Every shortest path to the destination is made of flagged arcs, so the path is as short
+ * as the one of dijkstra
+ * @param context - search context where the distances and paths are saved
+ * @param origin - integer representing the id of starting node
+ * @param dest - integer representing the id of destination node
+ * @param processedEdges - set that stores the id of th edges that are processed
+ * @return - true if it runs successfully
+ */
+bool Graph::dijkstraArcFlags(SearchContext &context, const int origin, const int dest, unordered_set<int> &processedEdges) const {
+    // Initialize the context and find the origin and destination
+    int start = dijkstraInit(context, origin);
+    int final = findVertexIndex(dest);
+    processedEdges.clear();
 
-            // Save the edge that has been processed to be drawn later
-            processedEdges.insert(edge.getId());
+    // If it can't find the start vertex or the final vertex (or the flags are outdated) then it can't execute the algorithm
+    if(start == -1 || final == -1 || !csrUpdated || !arcFlagsUpdated) return false;
+    int cell = arcFlags.getCell(final);
 
-            // Relax the Child Vertex
-            // If the distance to the start node is bigger then the distance of the new path,
-            // then this is the new best path
-            if(forwardMin->dist + weight < childVertex->dist ) {
-                // The path is the vertex that leads to the Child Vertex by taking the edge saved in edgePath
-                childVertex->path = forwardMin;
-                childVertex->edgePath = edge;
+    SearchQueue minQueue(context.dist, context.queueIndex);
+    minQueue.insert(start);
 
-                // Recalculate G(childVertex)
-                childVertex->dist = forwardMin->dist + weight;
+    while(!minQueue.empty()) {
+        int min = minQueue.extractMin();
+        context.visited[min] = true;
 
-                // Recalculate F(childVertex)
-                childVertex->heuristicValue = childVertex->dist + heuristicDistance(childVertex, final);
+        // The algorithm ends when we dequeue the final vertex
+        if(min == final)
+            break;
 
+        // Relax the vertexes reached by the edges that start in the min vertex and lead to the cell of the final vertex
+        for(int arc = csr.offsets[min]; arc < csr.offsets[min + 1]; arc++) {
+            if(!arcFlags.leadsTo(arc, cell)) continue;
+            int childVertex = csr.targets[arc];
+            context.touch(childVertex);
+            if(context.visited[childVertex]) continue;
+            processedEdges.insert(csr.edgeIds[arc]);
 
-                // if childVertex is not in queue, insert it, otherwise, update the queue with the new path
-                if(childVertex->queueIndex == 0) forwardMinQueue.insert(childVertex);
-                else forwardMinQueue.decreaseKey(childVertex);
+            if(context.dist[childVertex] > context.dist[min] + csr.weights[arc]) {
+                context.dist[childVertex] = context.dist[min] + csr.weights[arc];
+                context.path[childVertex] = min;
+                context.edgePath[childVertex] = arc;
+
+                if(context.queueIndex[childVertex] == 0) minQueue.insert(childVertex);
+                else minQueue.decreaseKey(childVertex);
             }
         }
 
-        // Since our graph is bidirectional we iterate over all the edges that end in the vertex
-        for(Edge edge : forwardMin->invAdj) {
-            Vertex* fatherVertex = edge.origin;
-            int weight = edge.weight;
-
-            // If the Father Vertex as already been dequeued then we can skip it
-            if(fatherVertex->visited) continue;
-
-            // Save the edge that has been processed to be drawn later
-            processedEdges.insert(edge.getId());
-
-            // Relax the Father Vertex
-            // If the distance to the central is bigger then the distance of the new path,
-            // then this is the new best path
-            if(forwardMin->dist + weight < fatherVertex->dist ) {
-                // The path is the vertex that leads to the Father Vertex by taking the edge saved in edgePath
-                fatherVertex->path = forwardMin;
-                fatherVertex->edgePath = edge;
+        // Since our graph is bidirectional we do the same with the edges that end in the min vertex
+        for(int arc = csr.invOffsets[min]; arc < csr.invOffsets[min + 1]; arc++) {
+            if(!arcFlags.invLeadsTo(arc, cell)) continue;
+            int fatherVertex = csr.invTargets[arc];
+            context.touch(fatherVertex);
+            if(context.visited[fatherVertex]) continue;
+            processedEdges.insert(csr.invEdgeIds[arc]);
 
-                // Recalculate G(fatherVertex)
-                fatherVertex->dist = forwardMin->dist + weight;
+            if(context.dist[fatherVertex] > context.dist[min] + csr.invWeights[arc]) {
+                context.dist[fatherVertex] = context.dist[min] + csr.invWeights[arc];
+                context.path[fatherVertex] = min;
+                context.edgePath[fatherVertex] = csr.invArcs[arc];
 
-                // Recalculate F(fatherVertex)
-                fatherVertex->heuristicValue = fatherVertex->dist + heuristicDistance(fatherVertex, final);
-
-                // if fatherVertex is not in queue, insert it, otherwise, update the queue with the new path
-                if(fatherVertex->queueIndex == 0) forwardMinQueue.insert(fatherVertex);
-                else forwardMinQueue.decreaseKey(fatherVertex);
+                if(context.queueIndex[fatherVertex] == 0) minQueue.insert(fatherVertex);
+                else minQueue.decreaseKey(fatherVertex);
             }
         }
+    }
 
-        // If the vertex was already processed in the backward search then save the vertex and end the search
-        if(find(backward_processed.begin(), backward_processed.end(), forwardMin->id) != backward_processed.end()) {
-            middle_vertex = forwardMin;
-            break;
-        }
-
-        /*
-         * Backward Search
-         */
-
-        // Extract the vertex with the minimum F() from the backward queue
-        backwardMin = backwardMinQueue.extractMin();
-        backwardMin->invVisited = true;
+    return true;
+}
 
-        // Add it to the processed vector
-        backward_processed.push_back(backwardMin->id);
+/**************** Contraction Hierarchies ************/
 
-        // Iterate over all the edges that end in the vertex
-        for(Edge edge : backwardMin->invAdj) {
-            Vertex* fatherVertex = edge.origin;
-            int weight = edge.weight;
+/**
+ * @brief Finds the best path between two points with the contraction hierarchy of the graph (built the first
+ * time it is needed), using the graph's own search context
+ * @param origin - integer representing the id of starting node
+ * @param dest - integer representing the id of destination node
+ * @param processedEdges - set that stores the id of th edges that are processed
+ * @return - true if it runs successfully
+ */
+bool Graph::contractionHierarchySearch(const int origin, const int dest, unordered_set<int> &processedEdges) {
+    updateContractionHierarchy();
+    return contractionHierarchySearch(defaultContext, origin, dest, processedEdges);
+}
 
-            // If the Father Vertex as already been dequeued then we can skip it
-            if(fatherVertex->invVisited) continue;
+/**
+ * @brief Finds the best path between two points with the contraction hierarchy of the graph.
+ * The shortcuts of the path are unpacked and the path is saved in the context like the other searches do,
+ * so getPathTo can be used with the destination afterwards
+ * @param context - search context where the distances and paths are saved
+ * @param origin - integer representing the id of starting node
+ * @param dest - integer representing the id of destination node
+ * @param processedEdges - set that stores the id of th edges that are processed
+ * @return - true if it runs successfully
+ */
+bool Graph::contractionHierarchySearch(SearchContext &context, const int origin, const int dest, unordered_set<int> &processedEdges) const {
+    // Initializes the context with both ends of the path
+    int start = dijkstraInit(context, origin);
+    int final = dijkstraBackwardsInit(context, dest);
+    processedEdges.clear();
 
-            // Save the edge that has been processed to be drawn later
-            processedEdgesInv.insert(edge.getId());
+    // If it can't find the start vertex or the final vertex (or the hierarchy is outdated) then it can't execute the algorithm
+    if(start == -1 || final == -1 || !csrUpdated || !chUpdated) return false;
 
-            // Relax the Father Vertex
-            // If the distance to the final node is bigger then the distance of the new path,
-            // then this is the new best path
-            if(backwardMin->invDist + weight < fatherVertex->invDist) {
-                // The invPath is the vertex that leads to the Father Vertex by taking the edge saved in invEdgePath
-                fatherVertex->invPath = backwardMin;
-                fatherVertex->invEdgePath = edge;
+    vector<int> pathVertexes, pathArcs;
+    ch.query(context, start, final, pathVertexes, pathArcs, processedEdges);
+    setContextPath(context, start, pathVertexes, pathArcs);
 
-                // Recalculate G(fatherVertex)
-                fatherVertex->invDist = backwardMin->invDist + weight;
+    return true;
+}
 
-                // Recalculate F(fatherVertex)
-                fatherVertex->invHeuristicValue = fatherVertex->invDist + heuristicDistance(fatherVertex, start);
+/**
+ * @brief Saves a path found by a hierarchy in the context, like the other searches do. The hierarchies use the
+ * context with their own arcs, so it starts again with only the vertexes of the path (empty if there is none),
+ * each one leading to the next by an arc of the csr
+ * @param context - search context where the path is saved
+ * @param start - index of the vertex where the path starts
+ * @param pathVertexes - vertexes of the path, from start to the end
+ * @param pathArcs - csr arcs of the path (pathArcs[i] connects pathVertexes[i] and pathVertexes[i + 1])
+ */
+void Graph::setContextPath(SearchContext &context, const int start, const vector<int> &pathVertexes, const vector<int> &pathArcs) const {
+    context.newSearch(vertexSet.size());
+    context.touch(start);
+    context.dist[start] = 0;
+    context.visited[start] = true;
+    for(size_t i = 0; i < pathArcs.size(); i++) {
+        int vertex = pathVertexes[i + 1];
+        context.touch(vertex);
+        context.dist[vertex] = context.dist[pathVertexes[i]] + csr.weights[pathArcs[i]];
+        context.path[vertex] = pathVertexes[i];
+        context.edgePath[vertex] = pathArcs[i];
+        context.visited[vertex] = true;
+    }
+}
 
-                // if fatherVertex is not in queue, insert it, otherwise, update the queue with the new path
-                if(fatherVertex->invQueueIndex == 0) backwardMinQueue.insert(fatherVertex);
-                else backwardMinQueue.decreaseKey(fatherVertex);
+/**************** Customizable Contraction Hierarchies ************/
 
-                continue;
-            }
-        }
+/**
+ * @brief Finds the best path between two points with the customizable contraction hierarchy of the graph (built
+ * the first time it is needed, and customized again after the weights change), using the graph's own search context
+ * @param origin - integer representing the id of starting node
+ * @param dest - integer representing the id of destination node
+ * @param processedEdges - set that stores the id of th edges that are processed
+ * @return - true if it runs successfully
+ */
+bool Graph::customizableHierarchySearch(const int origin, const int dest, unordered_set<int> &processedEdges) {
+    updateCustomizableHierarchy();
+    return customizableHierarchySearch(defaultContext, origin, dest, processedEdges);
+}
 
-        // Since our graph is bidirectional we iterate over all the edges that begin in the vertex
-        for(Edge edge : backwardMin->adj) {
-            Vertex* childVertex = edge.dest;
-            int weight = edge.weight;
+/**
+ * @brief Finds the best path between two points with the customizable contraction hierarchy of the graph.
+ * The path is saved in the context like the other searches do, so getPathTo can be used with the destination afterwards
+ * @param context - search context where the distances and paths are saved
+ * @param origin - integer representing the id of starting node
+ * @param dest - integer representing the id of destination node
+ * @param processedEdges - set that stores the id of th edges that are processed
+ * @return - true if it runs successfully
+ */
+bool Graph::customizableHierarchySearch(SearchContext &context, const int origin, const int dest, unordered_set<int> &processedEdges) const {
+    // Initializes the context with both ends of the path
+    int start = dijkstraInit(context, origin);
+    int final = dijkstraBackwardsInit(context, dest);
+    processedEdges.clear();
 
-            // If the childVertex as already been dequeued then we can skip it
-            if(childVertex->invVisited) continue;
+    // If it can't find the start vertex or the final vertex (or the hierarchy is outdated) then it can't execute the algorithm
+    if(start == -1 || final == -1 || !csrUpdated || !cchUpdated || !cchCustomized) return false;
 
-            // Save the edge that has been processed to be drawn later
-            processedEdgesInv.insert(edge.getId());
+    vector<int> pathVertexes, pathArcs;
+    cch.query(context, start, final, pathVertexes, pathArcs, processedEdges);
+    setContextPath(context, start, pathVertexes, pathArcs);
 
-            // Relax the Child Vertex
-            // If the distance to the start node is bigger then the distance of the new path,
-            // then this is the new best path
-            if(backwardMin->invDist + weight < childVertex->invDist) {
-                // The path is the vertex that leads to the Child Vertex by taking the edge saved in edgePath
-                childVertex->invPath = backwardMin;
-                childVertex->invEdgePath = edge;
+    return true;
+}
 
-                // Recalculate G(childVertex)
-                childVertex->invDist = backwardMin->invDist + weight;
+/**
+ * @brief Length of the shortest path between two vertexes, given by the hub labels of the graph (built the first
+ * time they are needed). Only the distance is found, not the path
+ * @param origin - vertex where the path starts
+ * @param dest - vertex where the path ends
+ * @return - the distance between the two vertexes, infinite if there is no path between them
+ */
+double Graph::hubLabelDistance(Vertex *origin, Vertex *dest) {
+    updateHubLabels();
+    return hubLabels.distance(origin->index, dest->index);
+}
 
-                // Recalculate F(childVertex)
-                childVertex->invHeuristicValue = childVertex->invDist + heuristicDistance(childVertex, start);
+/**************** Batches of queries ************/
 
-                // if childVertex is not in queue, insert it, otherwise, update the queue with the new path
-                if(childVertex->invQueueIndex == 0) backwardMinQueue.insert(childVertex);
-                else backwardMinQueue.decreaseKey(childVertex);
+/**
+ * @brief Answers a batch of shortest path queries, each one with its own algorithm, in parallel.
+ * What the algorithms of the batch need (csr, landmarks, contraction hierarchies, arc flags) is built first, then the queries are
+ * split between the workers of the scheduler of the graph, each one with its own search context, so they don't share any state
+ * @param queries - the queries to answer
+ * @param results - filled with the answer to each query, in the same order as the queries
+ * @return - true if every query found a path
+ */
+bool Graph::shortestPaths(const vector<PathQuery> &queries, vector<PathResult> &results) {
+    updateCSR();
+    for(const PathQuery &query : queries) {
+        if(query.algorithm == ORIENTED_SEARCH || query.algorithm == BIDIRECTIONAL) updateLandmarks();
+        if(query.algorithm == CONTRACTION_HIERARCHY) updateContractionHierarchy();
+        if(query.algorithm == ARC_FLAGS) updateArcFlags();
+        if(query.algorithm == CUSTOMIZABLE_CONTRACTION_HIERARCHY) updateCustomizableHierarchy();
+    }
 
-                continue;
-            }
+    results.assign(queries.size(), PathResult());
+    TaskScheduler &scheduler = *taskScheduler;
+    vector<SearchContext> contexts(scheduler.getNumWorkers());
+    scheduler.parallelFor(queries.size(), [&](const int item, const int worker) {
+        const PathQuery &query = queries[item];
+        PathResult &result = results[item];
+        SearchContext &context = contexts[worker];
+        unordered_set<int> processedEdges, processedEdgesInv;
+        auto start = steady_clock::now();
+
+        bool searched = false;
+        switch(query.algorithm) {
+            case DIJKSTRA: searched = dijkstra(context, query.origin, query.dest, processedEdges); break;
+            case ORIENTED_SEARCH: searched = dijkstraOrientedSearch(context, query.origin, query.dest, processedEdges); break;
+            case BIDIRECTIONAL: searched = dijkstraBidirectional(context, query.origin, query.dest, processedEdges, processedEdgesInv); break;
+            case CONTRACTION_HIERARCHY: searched = contractionHierarchySearch(context, query.origin, query.dest, processedEdges); break;
+            case ARC_FLAGS: searched = dijkstraArcFlags(context, query.origin, query.dest, processedEdges); break;
+            case CUSTOMIZABLE_CONTRACTION_HIERARCHY: searched = customizableHierarchySearch(context, query.origin, query.dest, processedEdges); break;
         }
 
-        // If the vertex was already processed in the forward search then save the vertex and end the search
-        if(find(processed.begin(), processed.end(), backwardMin->id) != processed.end()){
-            middle_vertex = backwardMin;
-            break;
+        // a path of a vertex to itself has no edges, the others must have at least one
+        if(searched) {
+            getPathTo(context, query.dest, result.edges);
+            result.found = query.origin == query.dest || !result.edges.empty();
+            for(const Edge &edge : result.edges) result.dist += edge.getWeight();
         }
-    }
+        result.processedEdges = processedEdges.size() + processedEdgesInv.size();
+        result.time = duration<double, micro>(steady_clock::now() - start).count();
+    });
 
-    // Save the distance from the start vertex to the final vertex to the middle vertex
-    int min_dist = middle_vertex->heuristicValue + middle_vertex->invHeuristicValue;
+    for(const PathResult &result : results)
+        if(!result.found) return false;
+    return true;
+}
 
-    // Search the forward queue to find a vertex that as a smaller distance from the start vertex
-    // to the final vertex
-    while(!forwardMinQueue.empty()) {
-        // Extract a vertex from the queue
-        forwardMin = forwardMinQueue.extractMin();
+/**************** Distance Tables ************/
 
-        // If the new vertex has a smaller distance then set it has the middle vertex
-        if(forwardMin->heuristicValue + forwardMin->invHeuristicValue < min_dist) {
-            min_dist = forwardMin->heuristicValue + forwardMin->invHeuristicValue;
-            middle_vertex = forwardMin;
-        }
+/**
+ * @brief Computes the distances between every source and every target with the contraction hierarchy of the
+ * graph (built the first time it is needed), using the graph's own search context
+ * @param table - table where the distances are saved
+ * @param sources - ids of the vertexes where the paths start
+ * @param targets - ids of the vertexes where the paths end
+ * @param keepPaths - if true, the paths can be read from the table with getTablePath
+ * @return - true if every vertex exists
+ */
+bool Graph::distanceTable(DistanceTable &table, const vector<int> &sources, const vector<int> &targets, const bool keepPaths) {
+    updateContractionHierarchy();
+    return distanceTable(defaultContext, table, sources, targets, keepPaths);
+}
+
+/**
+ * @brief Computes the distances between every source and every target with the contraction hierarchy of the graph,
+ * with one search per source and per target instead of one search per pair
+ * @param context - search context used by the searches (its previous search is lost)
+ * @param table - table where the distances are saved
+ * @param sources - ids of the vertexes where the paths start
+ * @param targets - ids of the vertexes where the paths end
+ * @param keepPaths - if true, the paths can be read from the table with getTablePath
+ * @return - true if every vertex exists (and the hierarchy is up to date)
+ */
+bool Graph::distanceTable(SearchContext &context, DistanceTable &table, const vector<int> &sources, const vector<int> &targets, const bool keepPaths) const {
+    table.clear();
+    if(!csrUpdated || !chUpdated) return false;
+
+    // The table works with the indexes of the vertexes
+    vector<int> sourceIndexes, targetIndexes;
+    for(int id : sources) {
+        sourceIndexes.push_back(findVertexIndex(id));
+        if(sourceIndexes.back() == -1) return false;
+    }
+    for(int id : targets) {
+        targetIndexes.push_back(findVertexIndex(id));
+        if(targetIndexes.back() == -1) return false;
     }
 
-    // Search the backward queue to find a vertex that as a smaller distance from the start vertex
-    // to the final vertex
-    while(!backwardMinQueue.empty()) {
-        // Extract a vertex from the queue
-        backwardMin = backwardMinQueue.extractMin();
+    table.build(ch, context, sourceIndexes, targetIndexes, keepPaths);
+    return true;
+}
 
-        // If the new vertex has a smaller distance then set it has the middle vertex
-        if(backwardMin->heuristicValue+ backwardMin->invHeuristicValue < min_dist){
-            min_dist = backwardMin->heuristicValue+ backwardMin->invHeuristicValue;
-            middle_vertex = backwardMin;
-        }
-    }
+/**
+ * @brief Saves the edges of the path between a source and a target of a distance table into a vector
+ * @param table - distance table built with keepPaths
+ * @param origin - id of the source where the path starts
+ * @param dest - id of the target where the path ends
+ * @param edges - vector of Edges where the edges of the path are added
+ * @return integer representing the distance from the origin to the destination (0 if there is no path)
+ */
+int Graph::getTablePath(const DistanceTable &table, const int origin, const int dest, vector<Edge> &edges) const {
+    int start = findVertexIndex(origin), final = findVertexIndex(dest);
+    if(start == -1 || final == -1) return false;
 
-    // Convert the invPath and invEdgePath to path and edgePath to be used in getPathTo (line 404)
-    while(middle_vertex->invPath != nullptr) {
-        // The invPath is the vertex that leads to midle_vertex from the backward search
-        // So we set path, edgePath, and dist of that vertex with the middle_vertex values
-        middle_vertex->invPath->path = middle_vertex;
-        middle_vertex->invPath->edgePath = middle_vertex->invEdgePath;
-        middle_vertex->invPath->dist = middle_vertex->dist + middle_vertex->invEdgePath.getWeight();
-        middle_vertex = middle_vertex->invPath;
+    int source = table.findSource(start), target = table.findTarget(final);
+    vector<int> pathVertexes, pathArcs;
+    if(source == -1 || target == -1 || !table.getPath(ch, source, target, pathVertexes, pathArcs)) return false;
+
+    for(size_t i = 0; i < pathArcs.size(); i++)
+        edges.push_back(getArcEdge(pathArcs[i], pathVertexes[i + 1], pathVertexes[i]));
+
+    return table.distance(source, target);
+}
+
+/**
+ * @brief Computes the distances and paths between every pair of points of interest, with one dijkstra per point
+ * that stops when it reaches all the points. The searches run in parallel, each worker with its own search context
+ * @param matrix - matrix where the distances and paths are saved
+ * @param points - ids of the points of interest
+ * @return - true if every vertex exists
+ */
+bool Graph::poiMatrix(PoiMatrix &matrix, const vector<int> &points) {
+    matrix.clear();
+    updateCSR();
+
+    // The matrix works with the indexes of the vertexes
+    vector<int> pointIndexes;
+    for(int id : points) {
+        pointIndexes.push_back(findVertexIndex(id));
+        if(pointIndexes.back() == -1) return false;
     }
+    matrix.init(pointIndexes);
+
+    // Each point is the start of a one to many search to every point
+    int numPoints = matrix.getNumPoints();
+    TaskScheduler &scheduler = *taskScheduler;
+    vector<SearchContext> contexts(scheduler.getNumWorkers());
+    vector<vector<int>> treePositions(contexts.size());
+    scheduler.parallelFor(numPoints, [&](const int source, const int worker) {
+        SearchContext &context = contexts[worker];
+        int start = dijkstraInit(context, vertexSet[matrix.getPoint(source)]->id);
+        oneToManySearch(context, start, matrix.getPoints());
+        matrix.setRow(source, context, treePositions[worker]);
+    });
 
     return true;
 }
 
-/**************** All Pairs Shortest Path  ***************/
+/**
+ * @brief Saves the edges of the path between two points of a points of interest matrix into a vector
+ * @param matrix - matrix built by poiMatrix
+ * @param origin - id of the point where the path starts
+ * @param dest - id of the point where the path ends
+ * @param edges - vector of Edges where the edges of the path are added
+ * @return integer representing the distance from the origin to the destination (0 if there is no path)
+ */
+int Graph::getTablePath(const PoiMatrix &matrix, const int origin, const int dest, vector<Edge> &edges) const {
+    int start = findVertexIndex(origin), final = findVertexIndex(dest);
+    if(start == -1 || final == -1) return false;
 
-void Graph::floydWarshallShortestPath() {
-    int vertSize = this->vertexSet.size();
+    int source = matrix.findPoint(start), target = matrix.findPoint(final);
+    vector<int> pathVertexes, pathArcs;
+    if(source == -1 || target == -1 || !matrix.getPath(source, target, pathVertexes, pathArcs)) return false;
 
-    this->minDistance.resize(vertSize);
-    for(auto &elem : this->minDistance) elem.resize(vertSize);
+    for(size_t i = 0; i < pathArcs.size(); i++)
+        edges.push_back(getArcEdge(pathArcs[i], pathVertexes[i + 1], pathVertexes[i]));
 
-    this->next.resize(vertSize);
-    for(auto &elem : next) elem.resize(vertSize);
+    return matrix.distance(source, target);
+}
 
-    // this->minDistance -> <vector<vector<double>> that stores distance between i and j
-    // this->next        -> <vector<vector<Vertex<T>*>> that stores the path between i and j
-    for(int i = 0; i < vertSize; i++) {
-        for(int j = 0; j < vertSize; j++) {
-            this->minDistance.at(i).at(j) = infinite;
-            this->next.at(i).at(j) = nullptr;
+/**************** All Pairs Shortest Path  ***************/
+
+/**
+ * @brief Relaxes the block of the distance matrix that starts in (i0, j0) through the intermediate vertexes
+ * of the block that starts in k0 (each block has floydBlock x floydBlock vertexes)
+ */
+void Graph::floydWarshallBlock(const int k0, const int i0, const int j0) {
+    for(int k = k0; k < k0 + floydBlock; k++) {
+        const float *rowK = &minDistance[(size_t) k * floydSize];
+        for(int i = i0; i < i0 + floydBlock; i++) {
+            float *rowI = &minDistance[(size_t) i * floydSize];
+            int *nextI = &next[(size_t) i * floydSize];
+            float distIK = rowI[k];
+            if(distIK == numeric_limits<float>::infinity()) continue;
+
+            for(int j = j0; j < j0 + floydBlock; j++)
+                if(distIK + rowK[j] < rowI[j]) {
+                    rowI[j] = distIK + rowK[j];
+                    nextI[j] = nextI[k];
+                }
         }
     }
+}
 
-    for(Vertex *vertex : this->vertexSet) {
-        for(Edge &edge : vertex->adj) {
-            int u = -1;
-            int v = -1;
+/**
+ * @brief Computes the shortest distance between every pair of vertexes (following the edges in their direction),
+ * in a matrix of floats stored in a single array, with the next vertex of each path as an index.
+ * The matrix is split in blocks that fit in the cache: for each block of intermediate vertexes, its diagonal block
+ * is relaxed first, then the blocks in its row and column, and then every other block, in parallel
+ */
+void Graph::floydWarshallShortestPath() {
+    int vertSize = this->vertexSet.size();
 
-            for(int k = 0; k < vertSize; k++) {
-                if(this->vertexSet.at(k)->id == vertex->id) u = k;
-                if(this->vertexSet.at(k)->id == edge.dest->id) v = k;
-            }
+    // the size of the matrix is rounded up to a multiple of the block, the extra vertexes aren't connected
+    this->floydSize = (vertSize + floydBlock - 1) / floydBlock * floydBlock;
+    this->minDistance.assign((size_t) floydSize * floydSize, numeric_limits<float>::infinity());
+    this->next.assign((size_t) floydSize * floydSize, -1);
+
+    // the csr already stores the index of both ends of every edge
+    updateCSR();
+    for(int u = 0; u < vertSize; u++) {
+        for(int arc = csr.offsets[u]; arc < csr.offsets[u + 1]; arc++) {
+            int v = csr.targets[arc];
 
             // for each edge dist[u][v] = weight(u, v)
-            this->minDistance.at(u).at(v) = edge.weight;
-            this->next.at(u).at(v) = edge.dest;
+            size_t position = (size_t) u * floydSize + v;
+            if(csr.weights[arc] < this->minDistance[position]) {
+                this->minDistance[position] = csr.weights[arc];
+                this->next[position] = v;
+            }
         }
     }
 
     // for each vertex dist[v][v] = 0
-    for(int i = 0; i < vertSize; i++) {
-        this->minDistance.at(i).at(i) = 0;
-        this->next.at(i).at(i) = this->vertexSet.at(i);
+    for(int i = 0; i < floydSize; i++) {
+        this->minDistance[(size_t) i * floydSize + i] = 0;
+        this->next[(size_t) i * floydSize + i] = i;
     }
 
-    for(int k = 0; k < vertSize; k++) {
-        for (int i = 0; i < vertSize; i++) {
-            for(int j = 0; j < vertSize; j++) {
-                if(this->minDistance.at(i).at(j) > this->minDistance.at(i).at(k) + this->minDistance.at(k).at(j)) {
-                    this->minDistance.at(i).at(j) = this->minDistance.at(i).at(k) + this->minDistance.at(k).at(j);
-                    this->next.at(i).at(j) = this->next.at(i).at(k);
-                }
-            }
-        }
+    int numBlocks = floydSize / floydBlock;
+    TaskScheduler &scheduler = *taskScheduler;
+    for(int k = 0; k < numBlocks; k++) {
+        int k0 = k * floydBlock;
+        floydWarshallBlock(k0, k0, k0);
+
+        // the blocks in the same row and column as the diagonal one only depend on it
+        scheduler.parallelFor(2 * numBlocks, [&](const int item, const int) {
+            int other = item / 2;
+            if(other == k) return;
+            if(item % 2 == 0) floydWarshallBlock(k0, k0, other * floydBlock);
+            else floydWarshallBlock(k0, other * floydBlock, k0);
+        });
+
+        // every other block depends on the ones of its row and column, so each row of blocks is independent
+        scheduler.parallelFor(numBlocks, [&](const int i, const int) {
+            if(i == k) return;
+            for(int j = 0; j < numBlocks; j++)
+                if(j != k) floydWarshallBlock(k0, i * floydBlock, j * floydBlock);
+        });
     }
 }
 
+/**
+ * @brief Path between two vertexes found by floydWarshallShortestPath
+ * @param orig - id of the vertex where the path starts
+ * @param dest - id of the vertex where the path ends
+ * @return the ids of the vertexes of the path, empty if there is none (or the weights changed since the matrix was computed)
+ */
 vector<int> Graph::getfloydWarshallPath(const int orig, const int dest) const {
     vector<int> res;
-    int vertSize = this->vertexSet.size();
-
-    Vertex *init, *final;
-    init = this->findVertex(orig);
-    final = this->findVertex(dest);
-    if(init == nullptr || final == nullptr) return res;
-
-    int initIndex, finalIndex;
-    for(int i = 0; i < vertSize; i++)
-        if(this->vertexSet.at(i)->id == init->id) initIndex = i;
-
-    for(int i = 0; i < vertSize; i++)
-        if(this->vertexSet.at(i)->id == final->id) finalIndex = i;
 
-    if(this->next.at(initIndex).at(finalIndex) == nullptr) return res;
+    int initIndex = findVertexIndex(orig), finalIndex = findVertexIndex(dest);
+    if(initIndex == -1 || finalIndex == -1 || initIndex >= floydSize || finalIndex >= floydSize) return res;
+    if(this->next[(size_t) initIndex * floydSize + finalIndex] == -1) return res;
 
-    res.push_back(init->id);
-    while(init->id != final->id) {
-        init = next.at(initIndex).at(finalIndex);
-        res.push_back(init->id);
-        for(int i = 0; i < vertSize; i++)
-            if(this->vertexSet.at(i)->id == init->id) initIndex = i;
+    res.push_back(orig);
+    while(initIndex != finalIndex) {
+        initIndex = this->next[(size_t) initIndex * floydSize + finalIndex];
+        res.push_back(this->vertexSet[initIndex]->id);
     }
 
     return res;
 }
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,145 @@
+#pragma once
+#ifndef HUB_LABELS_H_
+#define HUB_LABELS_H_
+
+#include <vector>
+#include <algorithm>
+#include <limits>
+#include "ContractionHierarchy.h"
+
+using namespace std;
+
+/**
+ * Hub labels of the graph, built from its contraction hierarchy.
+ * Each vertex gets a label: a list of hubs (vertexes) with its distance to each one of them, such that any two
+ * vertexes have, in their labels, a hub that is on a shortest path between them. The distance between two vertexes
+ * is then the smallest sum of the distances to a hub both labels share, found by merging the two sorted labels.
+ * Like the other searches, the edges are followed in both directions, so a single label per vertex is enough.
+ */
+class HubLabels {
+private:
+    vector<int> offsets;            // label of each vertex (size = numVertex + 1)
+    vector<int> hubs;               // hubs of each label, sorted by index
+    vector<double> distances;       // distance of the vertex to each hub of its label
+
+public:
+    void build(const ContractionHierarchy &ch);
+    void clear();
+    double distance(const int origin, const int dest) const;
+
+    int getNumVertex() const;
+    double getAverageLabelSize() const;
+    size_t getMemoryUsage() const;
+};
+
+/**
+ * @brief Builds the labels from the most important vertex of the hierarchy to the least important one.
+ * The label of a vertex is itself plus the labels of its upward neighbours, extended by the arcs to them.
+ * The hubs whose distance is longer than another path given by the labels are not on a shortest path, so they
+ * are removed, which keeps the labels small
+ * @param ch - contraction hierarchy of the graph
+ */
+void HubLabels::build(const ContractionHierarchy &ch) {
+    clear();
+    int numVertex = ch.rank.size();
+
+    vector<int> order(numVertex);
+    for(int vertex = 0; vertex < numVertex; vertex++)
+        order[numVertex - 1 - ch.rank[vertex]] = vertex;
+
+    vector<vector<pair<int, double>>> labels(numVertex);
+    vector<pair<int, double>> candidates;
+    vector<double> candidateDist(numVertex, numeric_limits<double>::infinity());
+
+    for(int vertex : order) {
+        // every upward neighbour was labeled before, since it is more important
+        candidates.clear();
+        candidates.push_back(make_pair(vertex, 0));
+        for(int arc = ch.upOffsets[vertex]; arc < ch.upOffsets[vertex + 1]; arc++)
+            for(const pair<int, double> &entry : labels[ch.upTargets[arc]])
+                candidates.push_back(make_pair(entry.first, entry.second + ch.upWeights[arc]));
+
+        // the same hub may come from several neighbours, only the shortest distance is kept
+        sort(candidates.begin(), candidates.end());
+        candidates.erase(unique(candidates.begin(), candidates.end(), [](const pair<int, double> &a, const pair<int, double> &b) {
+            return a.first == b.first;
+        }), candidates.end());
+        for(const pair<int, double> &entry : candidates)
+            candidateDist[entry.first] = entry.second;
+
+        vector<pair<int, double>> &label = labels[vertex];
+        for(const pair<int, double> &entry : candidates) {
+            bool shortest = true;
+            for(const pair<int, double> &hubEntry : labels[entry.first])
+                if(candidateDist[hubEntry.first] + hubEntry.second < entry.second) {
+                    shortest = false;
+                    break;
+                }
+            if(shortest) label.push_back(entry);
+        }
+
+        for(const pair<int, double> &entry : candidates)
+            candidateDist[entry.first] = numeric_limits<double>::infinity();
+    }
+
+    // the labels are kept in contiguous arrays, in the order of the vertexes
+    offsets.assign(numVertex + 1, 0);
+    for(int vertex = 0; vertex < numVertex; vertex++)
+        offsets[vertex + 1] = offsets[vertex] + labels[vertex].size();
+    hubs.reserve(offsets[numVertex]);
+    distances.reserve(offsets[numVertex]);
+    for(int vertex = 0; vertex < numVertex; vertex++)
+        for(const pair<int, double> &entry : labels[vertex]) {
+            hubs.push_back(entry.first);
+            distances.push_back(entry.second);
+        }
+}
+
+void HubLabels::clear() {
+    offsets.clear();
+    hubs.clear();
+    distances.clear();
+}
+
+/**
+ * @param origin - index of a vertex
+ * @param dest - index of another vertex
+ * @return - the length of the shortest path between the two vertexes (infinite if there is none)
+ */
+double HubLabels::distance(const int origin, const int dest) const {
+    double best = numeric_limits<double>::infinity();
+    int i = offsets[origin], j = offsets[dest];
+    int originEnd = offsets[origin + 1], destEnd = offsets[dest + 1];
+
+    while(i < originEnd && j < destEnd) {
+        if(hubs[i] < hubs[j]) i++;
+        else if(hubs[i] > hubs[j]) j++;
+        else {
+            best = min(best, distances[i] + distances[j]);
+            i++;
+            j++;
+        }
+    }
+
+    return best;
+}
+
+int HubLabels::getNumVertex() const {
+    return offsets.empty() ? 0 : offsets.size() - 1;
+}
+
+/**
+ * @return - the average number of hubs in the label of a vertex
+ */
+double HubLabels::getAverageLabelSize() const {
+    return getNumVertex() == 0 ? 0 : (double) hubs.size() / getNumVertex();
+}
+
+/**
+ * @return number of bytes used by the labels
+ */
+size_t HubLabels::getMemoryUsage() const {
+    return (offsets.size() + hubs.size()) * sizeof(int) + distances.size() * sizeof(double);
+}
+
+#endif
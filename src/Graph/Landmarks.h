@@ -0,0 +1,234 @@
+#pragma once
+#ifndef LANDMARKS_H_
+#define LANDMARKS_H_
+
+#include <vector>
+#include <queue>
+#include <functional>
+#include <algorithm>
+#include <random>
+#include <cmath>
+#include <limits>
+#include "CSRGraph.h"
+
+using namespace std;
+
+/**
+ * Landmarks used by the ALT (A*, landmarks and triangle inequality) heuristic.
+ * The distances between a few chosen vertexes (the landmarks) and every vertex are computed once, and then
+ * |dist(landmark, target) - dist(landmark, vertex)| is a lower bound of the distance from the vertex to the target.
+ * Like the searches, the edges are followed in both directions, so a single table per landmark is enough.
+ */
+class Landmarks {
+public:
+    enum Strategy {FARTHEST, AVOID};
+
+private:
+    vector<int> landmarks;          // index of each landmark
+    vector<double> distances;       // distances[vertex * numLandmarks + landmark], so each vertex uses one cache line
+    int numVertex = 0;
+
+    void shortestPaths(const CSRGraph &csr, const int source, vector<double> &dist, vector<int> &parent) const;
+    int chooseFarthest(const vector<double> &minDist) const;
+    int chooseAvoid(const CSRGraph &csr, const int root) const;
+
+public:
+    void build(const CSRGraph &csr, const int numLandmarks, const Strategy strategy);
+    void clear();
+    inline double lowerBound(const int vertex, const int target) const;
+
+    int getNumLandmarks() const;
+    const vector<int> &getLandmarks() const;
+    size_t getMemoryUsage() const;
+};
+
+/**
+ * @brief Dijkstra from the source to every vertex, following the arcs in both directions
+ * @param csr - CSR arrays of the graph
+ * @param source - index of the vertex where the search starts
+ * @param dist - filled with the distance of each vertex to the source (infinite if it can't be reached)
+ * @param parent - filled with the vertex that leads to each vertex in the shortest path tree (-1 for the source)
+ */
+void Landmarks::shortestPaths(const CSRGraph &csr, const int source, vector<double> &dist, vector<int> &parent) const {
+    dist.assign(numVertex, numeric_limits<double>::infinity());
+    parent.assign(numVertex, -1);
+    priority_queue<pair<double, int>, vector<pair<double, int>>, greater<pair<double, int>>> queue;
+
+    dist[source] = 0;
+    queue.push(make_pair(0, source));
+
+    while(!queue.empty()) {
+        double vertexDist = queue.top().first;
+        int vertex = queue.top().second;
+        queue.pop();
+        if(vertexDist > dist[vertex]) continue;
+
+        for(int arc = csr.offsets[vertex]; arc < csr.offsets[vertex + 1]; arc++)
+            if(vertexDist + csr.weights[arc] < dist[csr.targets[arc]]) {
+                dist[csr.targets[arc]] = vertexDist + csr.weights[arc];
+                parent[csr.targets[arc]] = vertex;
+                queue.push(make_pair(dist[csr.targets[arc]], csr.targets[arc]));
+            }
+
+        for(int arc = csr.invOffsets[vertex]; arc < csr.invOffsets[vertex + 1]; arc++)
+            if(vertexDist + csr.invWeights[arc] < dist[csr.invTargets[arc]]) {
+                dist[csr.invTargets[arc]] = vertexDist + csr.invWeights[arc];
+                parent[csr.invTargets[arc]] = vertex;
+                queue.push(make_pair(dist[csr.invTargets[arc]], csr.invTargets[arc]));
+            }
+    }
+}
+
+/**
+ * @param minDist - distance of each vertex to the closest landmark already chosen
+ * @return - the reachable vertex that is the farthest away from all the landmarks already chosen
+ */
+int Landmarks::chooseFarthest(const vector<double> &minDist) const {
+    int farthest = 0;
+    double farthestDist = -1;
+    for(int vertex = 0; vertex < numVertex; vertex++)
+        if(minDist[vertex] != numeric_limits<double>::infinity() && minDist[vertex] > farthestDist) {
+            farthest = vertex;
+            farthestDist = minDist[vertex];
+        }
+    return farthest;
+}
+
+/**
+ * @brief Avoid strategy (Goldberg and Harrelson): builds the shortest path tree of the root and gives each vertex
+ * a weight equal to how much the current landmarks underestimate its distance to the root. Then descends from the
+ * root, always to the child with the heaviest subtree (subtrees that already have a landmark weigh 0), and returns
+ * the leaf reached, which is in the region the current landmarks cover worst
+ * @param csr - CSR arrays of the graph
+ * @param root - index of the root of the tree
+ * @return - the index of the new landmark
+ */
+int Landmarks::chooseAvoid(const CSRGraph &csr, const int root) const {
+    vector<double> dist;
+    vector<int> parent;
+    shortestPaths(csr, root, dist, parent);
+
+    // the vertexes sorted by distance to the root, so the children come after their parents
+    vector<int> order;
+    for(int vertex = 0; vertex < numVertex; vertex++)
+        if(dist[vertex] != numeric_limits<double>::infinity()) order.push_back(vertex);
+    sort(order.begin(), order.end(), [&dist](const int a, const int b) { return dist[a] < dist[b]; });
+
+    vector<double> size(numVertex, 0);
+    vector<bool> hasLandmark(numVertex, false);
+    for(int landmark : landmarks) hasLandmark[landmark] = true;
+
+    // sizes of the subtrees, from the leaves to the root
+    for(auto it = order.rbegin(); it != order.rend(); it++) {
+        int vertex = *it;
+        size[vertex] += dist[vertex] - lowerBound(vertex, root);
+        if(hasLandmark[vertex]) size[vertex] = 0;
+        if(parent[vertex] != -1) {
+            if(hasLandmark[vertex]) hasLandmark[parent[vertex]] = true;
+            size[parent[vertex]] += size[vertex];
+        }
+    }
+
+    // the heaviest child of each vertex
+    vector<int> heaviest(numVertex, -1);
+    for(int vertex : order) {
+        int father = parent[vertex];
+        if(father == -1 || size[vertex] == 0) continue;
+        if(heaviest[father] == -1 || size[vertex] > size[heaviest[father]]) heaviest[father] = vertex;
+    }
+
+    int vertex = root;
+    while(heaviest[vertex] != -1) vertex = heaviest[vertex];
+    return vertex;
+}
+
+/**
+ * @brief Chooses the landmarks and computes the distance between each one of them and every vertex
+ * @param csr - CSR arrays of the graph
+ * @param numLandmarks - number of landmarks to choose (less if the graph is smaller)
+ * @param strategy - FARTHEST chooses each landmark as far as possible from the previous ones,
+ * AVOID chooses them in the regions where the previous ones give the worst lower bounds
+ */
+void Landmarks::build(const CSRGraph &csr, const int numLandmarks, const Strategy strategy) {
+    clear();
+    numVertex = csr.getNumVertex();
+    if(numVertex == 0 || numLandmarks <= 0) return;
+
+    vector<vector<double>> tables;
+    vector<double> dist, minDist(numVertex, numeric_limits<double>::infinity());
+    vector<int> parent;
+    mt19937 random(numVertex);
+
+    // the first landmark is the vertex farthest from an arbitrary vertex
+    shortestPaths(csr, 0, minDist, parent);
+    int landmark = chooseFarthest(minDist);
+
+    while((int) landmarks.size() < numLandmarks && (int) landmarks.size() < numVertex) {
+        landmarks.push_back(landmark);
+        shortestPaths(csr, landmark, dist, parent);
+        tables.push_back(dist);
+
+        // the distance table is kept in the final layout as soon as each landmark is added, since the lower bounds
+        // are used to choose the next landmarks
+        distances.assign(numVertex * landmarks.size(), 0);
+        for(int vertex = 0; vertex < numVertex; vertex++)
+            for(size_t l = 0; l < landmarks.size(); l++)
+                distances[vertex * landmarks.size() + l] = tables[l][vertex];
+
+        for(int vertex = 0; vertex < numVertex; vertex++)
+            minDist[vertex] = landmarks.size() == 1 ? dist[vertex] : min(minDist[vertex], dist[vertex]);
+
+        if(strategy == FARTHEST) landmark = chooseFarthest(minDist);
+        else landmark = chooseAvoid(csr, random() % numVertex);
+
+        // a landmark chosen twice adds nothing, the farthest vertex is used instead
+        if(find(landmarks.begin(), landmarks.end(), landmark) != landmarks.end())
+            landmark = chooseFarthest(minDist);
+        if(find(landmarks.begin(), landmarks.end(), landmark) != landmarks.end())
+            break;
+    }
+}
+
+void Landmarks::clear() {
+    landmarks.clear();
+    distances.clear();
+    numVertex = 0;
+}
+
+/**
+ * @param vertex - index of a vertex
+ * @param target - index of another vertex
+ * @return - a lower bound of the distance between the two vertexes, by the triangle inequality
+ * (0 if there are no landmarks)
+ */
+double Landmarks::lowerBound(const int vertex, const int target) const {
+    int numLandmarks = landmarks.size();
+    const double *vertexDist = &distances[vertex * numLandmarks];
+    const double *targetDist = &distances[target * numLandmarks];
+
+    double bound = 0;
+    for(int l = 0; l < numLandmarks; l++) {
+        // landmarks that can't reach both vertexes say nothing about them
+        if(vertexDist[l] == numeric_limits<double>::infinity() || targetDist[l] == numeric_limits<double>::infinity())
+            continue;
+        bound = max(bound, fabs(targetDist[l] - vertexDist[l]));
+    }
+    return bound;
+}
+
+int Landmarks::getNumLandmarks() const {
+    return landmarks.size();
+}
+
+const vector<int> &Landmarks::getLandmarks() const {
+    return landmarks;
+}
+
+/**
+ * @return number of bytes used by the distance tables
+ */
+size_t Landmarks::getMemoryUsage() const {
+    return distances.size() * sizeof(double) + landmarks.size() * sizeof(int);
+}
+
+#endif
@@ -3,121 +3,119 @@
 #define SRC_MUTABLEPRIORITYQUEUE_H_
 
 #include <vector>
-
+#include <algorithm>
 
 using namespace std;
 
 /**
- * class T must have: (i) accessible field int queueIndex; (ii) operator< defined.
+ * Index policy that keeps the position of each vertex in an external vector indexed by the vertex,
+ * usually the queueIndex of a SearchContext. A vector can be given wherever the policy is expected.
  */
+class VectorIndex {
+    vector<int> &positions;
 
-template <class T>
+public:
+    VectorIndex(vector<int> &positions) : positions(positions) {}
+    int get(const int x) const { return positions[x]; }
+    void set(const int x, const int position) { positions[x] = position; }
+};
+
+/**
+ * d-ary heap of vertex indexes, ordered by key[vertex].
+ * Each node of the heap stores the key of its vertex next to the vertex, so comparing the children of a node reads
+ * consecutive memory instead of the key array, and the arity children of a node share one or two cache lines.
+ * The key is copied from key[vertex] when the vertex is inserted or its key decreases.
+ * The position of each vertex in the heap, plus 1 (0 if it is not in the heap), is kept by the index policy,
+ * so with the default policy the queueIndex of a SearchContext tells whether a vertex is in the queue.
+ */
+template <class T, int arity = 4, class IndexPolicy = VectorIndex>
 class MutablePriorityQueue {
-    vector<T *> H;
+    struct Node {
+        T key;
+        int x;
+    };
+
+    vector<Node> H;
+    const vector<T> &key;
+    IndexPolicy index;
     void heapifyUp(unsigned i);
     void heapifyDown(unsigned i);
-    inline void set(unsigned i, T * x);
+    inline void set(unsigned i, const Node &node);
 
 public:
-    MutablePriorityQueue();
-    void insert(T * x);
-    T * extractMin();
-    void decreaseKey(T * x);
+    MutablePriorityQueue(const vector<T> &key, IndexPolicy index);
+    void insert(int x);
+    int extractMin();
+    void decreaseKey(int x);
     bool empty();
-    bool inv = false;
-
-    void setInv(bool t);
 };
 
-// Index calculations
-#define parent(i) ((i) / 2)
-#define leftChild(i) ((i) * 2)
-
-template<class T>
-void MutablePriorityQueue<T>::setInv(bool t) {
-    this->inv = t;
-}
-
-template <class T>
-MutablePriorityQueue<T>::MutablePriorityQueue() {
-    H.push_back(nullptr);
-    // indices will be used starting in 1
-    // to facilitate parent/child calculations
-}
+template <class T, int arity, class IndexPolicy>
+MutablePriorityQueue<T, arity, IndexPolicy>::MutablePriorityQueue(const vector<T> &key, IndexPolicy index) : key(key), index(index) {}
 
-template <class T>
-bool MutablePriorityQueue<T>::empty() {
-    return H.size() == 1;
+template <class T, int arity, class IndexPolicy>
+bool MutablePriorityQueue<T, arity, IndexPolicy>::empty() {
+    return H.empty();
 }
 
-template <class T>
-T* MutablePriorityQueue<T>::extractMin() {
-    auto x = H[1];
-    H[1] = H.back();
+template <class T, int arity, class IndexPolicy>
+int MutablePriorityQueue<T, arity, IndexPolicy>::extractMin() {
+    int x = H[0].x;
+    H[0] = H.back();
     H.pop_back();
-    heapifyDown(1);
-    if(inv){
-        x->invQueueIndex = 0;
-    }
-    else{
-        x->queueIndex = 0;
-    }
+    if(!H.empty()) heapifyDown(0);
+    index.set(x, 0);
     return x;
 }
 
-template <class T>
-void MutablePriorityQueue<T>::insert(T *x) {
-    H.push_back(x);
-    heapifyUp(H.size()-1);
+template <class T, int arity, class IndexPolicy>
+void MutablePriorityQueue<T, arity, IndexPolicy>::insert(int x) {
+    H.push_back({key[x], x});
+    heapifyUp(H.size() - 1);
 }
 
-template <class T>
-void MutablePriorityQueue<T>::decreaseKey(T *x) {
-    if(inv){
-        heapifyUp(x->invQueueIndex);
-
-    }
-    else{
-        heapifyUp(x->queueIndex);
-    }
+template <class T, int arity, class IndexPolicy>
+void MutablePriorityQueue<T, arity, IndexPolicy>::decreaseKey(int x) {
+    unsigned i = index.get(x) - 1;
+    H[i].key = key[x];
+    heapifyUp(i);
 }
 
-template <class T>
-void MutablePriorityQueue<T>::heapifyUp(unsigned i) {
-    auto x = H[i];
-    while (i > 1 && *x < *H[parent(i)]) {
-        set(i, H[parent(i)]);
-        i = parent(i);
+template <class T, int arity, class IndexPolicy>
+void MutablePriorityQueue<T, arity, IndexPolicy>::heapifyUp(unsigned i) {
+    Node node = H[i];
+    while(i > 0) {
+        unsigned parent = (i - 1) / arity;
+        if(!(node.key < H[parent].key)) break;
+        set(i, H[parent]);
+        i = parent;
     }
-    set(i, x);
+    set(i, node);
 }
 
-template <class T>
-void MutablePriorityQueue<T>::heapifyDown(unsigned i) {
-    auto x = H[i];
-    while (true) {
-        unsigned k = leftChild(i);
-        if (k >= H.size())
-            break;
-        if (k+1 < H.size() && *H[k+1] < *H[k])
-            ++k; // right child of i
-        if ( ! (*H[k] < *x) )
-            break;
+template <class T, int arity, class IndexPolicy>
+void MutablePriorityQueue<T, arity, IndexPolicy>::heapifyDown(unsigned i) {
+    Node node = H[i];
+    while(true) {
+        unsigned first = i * arity + 1;
+        if(first >= H.size()) break;
+
+        // smallest of the children of i
+        unsigned last = min<unsigned>(first + arity, H.size()), k = first;
+        for(unsigned child = first + 1; child < last; child++)
+            if(H[child].key < H[k].key) k = child;
+
+        if(!(H[k].key < node.key)) break;
         set(i, H[k]);
         i = k;
     }
-    set(i, x);
+    set(i, node);
 }
 
-template <class T>
-void MutablePriorityQueue<T>::set(unsigned i, T * x) {
-    H[i] = x;
-    if(inv){
-        x->invQueueIndex = i;
-    }
-    else{
-        x->queueIndex = i;
-    }
+template <class T, int arity, class IndexPolicy>
+void MutablePriorityQueue<T, arity, IndexPolicy>::set(unsigned i, const Node &node) {
+    H[i] = node;
+    index.set(node.x, i + 1);
 }
 
-#endif
\ No newline at end of file
+#endif
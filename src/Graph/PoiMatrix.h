@@ -0,0 +1,188 @@
+#pragma once
+#ifndef POI_MATRIX_H_
+#define POI_MATRIX_H_
+
+#include <vector>
+#include <unordered_map>
+#include <algorithm>
+#include <limits>
+#include "SearchContext.h"
+
+using namespace std;
+
+/**
+ * Shortest distances and paths between every pair of a set of points of interest, filled with one search
+ * per point (Graph::poiMatrix). Only the part of the shortest path tree of each search that leads to the points
+ * is kept, so the matrix grows with the points and not with the graph.
+ * The rows of different points are independent, so they can be filled at the same time, each one from its own
+ * search context.
+ */
+class PoiMatrix {
+private:
+    struct TreeEntry {
+        int vertex;                 // index of the vertex
+        int parent;                 // position of the vertex that leads to it in the same tree (-1 in the root)
+        int arc;                    // csr arc between the parent and the vertex (-1 in the root)
+    };
+
+    vector<int> points;             // index of the vertex of each point
+    unordered_map<int, int> positions;          // position of each point in the matrix, by vertex index
+
+    vector<double> distances;       // distances[source * numPoints + target]
+    vector<int> targetEntries;      // position of the target in the tree of the source (-1 if it wasn't reached)
+    vector<vector<TreeEntry>> trees;            // shortest path tree of each point, pruned to the paths to the points
+
+public:
+    void init(const vector<int> &points);
+    void setRow(const int source, const SearchContext &context, vector<int> &treePosition);
+    void clear();
+
+    int findPoint(const int vertex) const;
+    int getPoint(const int point) const;
+    const vector<int> &getPoints() const;
+    double distance(const int source, const int target) const;
+    bool getPath(const int source, const int target, vector<int> &pathVertexes, vector<int> &pathArcs) const;
+
+    int getNumPoints() const;
+    size_t getMemoryUsage() const;
+};
+
+/**
+ * @brief Sets the points of the matrix, with every distance still unknown (the searches fill them)
+ * @param points - index of the vertex of each point (repeated vertexes are kept only once)
+ */
+void PoiMatrix::init(const vector<int> &points) {
+    clear();
+    for(int vertex : points)
+        if(positions.insert(make_pair(vertex, this->points.size())).second) this->points.push_back(vertex);
+
+    int numPoints = this->points.size();
+    distances.assign(numPoints * numPoints, numeric_limits<double>::infinity());
+    targetEntries.assign(numPoints * numPoints, -1);
+    trees.assign(numPoints, vector<TreeEntry>());
+}
+
+/**
+ * @brief Fills the row of a point from a search that started in it and settled every point it could reach.
+ * Only writes to the row and tree of the source, so rows of different points can be filled at the same time
+ * @param source - position of the point in the matrix
+ * @param context - search context of the search
+ * @param treePosition - scratch array with one position per vertex, not shared with other rows being filled
+ */
+void PoiMatrix::setRow(const int source, const SearchContext &context, vector<int> &treePosition) {
+    int numPoints = points.size();
+    vector<TreeEntry> &tree = trees[source];
+    tree.clear();
+    if((int) treePosition.size() != context.getNumVertex()) treePosition.assign(context.getNumVertex(), 0);
+
+    // a vertex is in the tree if its position points back to it, so the scratch array is never reset
+    auto inTree = [&](const int vertex) {
+        return treePosition[vertex] < (int) tree.size() && tree[treePosition[vertex]].vertex == vertex;
+    };
+
+    vector<int> chain;
+    for(int target = 0; target < numPoints; target++) {
+        if(!context.getVisited(points[target])) continue;
+        distances[source * numPoints + target] = context.getDist(points[target]);
+
+        // the path to the target is added from the last vertex already in the tree (or the root) down to it
+        chain.clear();
+        int vertex = points[target];
+        for(; vertex != -1 && !inTree(vertex); vertex = context.getPath(vertex))
+            chain.push_back(vertex);
+
+        int parent = vertex == -1 ? -1 : treePosition[vertex];
+        for(auto it = chain.rbegin(); it != chain.rend(); it++) {
+            treePosition[*it] = tree.size();
+            tree.push_back({*it, parent, context.getEdgePath(*it)});
+            parent = treePosition[*it];
+        }
+
+        targetEntries[source * numPoints + target] = treePosition[points[target]];
+    }
+    tree.shrink_to_fit();
+}
+
+void PoiMatrix::clear() {
+    points.clear();
+    positions.clear();
+    distances.clear();
+    targetEntries.clear();
+    trees.clear();
+}
+
+/**
+ * @param vertex - index of a vertex
+ * @return - the position of the vertex in the points of the matrix, -1 if it isn't one of them
+ */
+int PoiMatrix::findPoint(const int vertex) const {
+    auto it = positions.find(vertex);
+    return it == positions.end() ? -1 : it->second;
+}
+
+/**
+ * @param point - position of a point in the matrix
+ * @return - the index of the vertex of the point
+ */
+int PoiMatrix::getPoint(const int point) const {
+    return points[point];
+}
+
+/**
+ * @return - the index of the vertex of each point, by position in the matrix
+ */
+const vector<int> &PoiMatrix::getPoints() const {
+    return points;
+}
+
+/**
+ * @param source - position of the point where the path starts
+ * @param target - position of the point where the path ends
+ * @return - the length of the shortest path from the source to the target (infinite if there is none)
+ */
+double PoiMatrix::distance(const int source, const int target) const {
+    return distances[source * points.size() + target];
+}
+
+/**
+ * @brief Builds the path between two points from the tree of the source
+ * @param source - position of the point where the path starts
+ * @param target - position of the point where the path ends
+ * @param pathVertexes - filled with the vertexes of the path, from the source to the target
+ * @param pathArcs - filled with the csr arcs of the path (pathArcs[i] connects pathVertexes[i] and pathVertexes[i + 1])
+ * @return - true if there is a path
+ */
+bool PoiMatrix::getPath(const int source, const int target, vector<int> &pathVertexes, vector<int> &pathArcs) const {
+    pathVertexes.clear();
+    pathArcs.clear();
+
+    int entry = targetEntries[source * points.size() + target];
+    if(entry == -1) return false;
+
+    const vector<TreeEntry> &tree = trees[source];
+    for(; tree[entry].parent != -1; entry = tree[entry].parent) {
+        pathVertexes.push_back(tree[entry].vertex);
+        pathArcs.push_back(tree[entry].arc);
+    }
+    pathVertexes.push_back(tree[entry].vertex);
+
+    reverse(pathVertexes.begin(), pathVertexes.end());
+    reverse(pathArcs.begin(), pathArcs.end());
+    return true;
+}
+
+int PoiMatrix::getNumPoints() const {
+    return points.size();
+}
+
+/**
+ * @return number of bytes used by the matrix and the trees
+ */
+size_t PoiMatrix::getMemoryUsage() const {
+    size_t treeEntries = 0;
+    for(const vector<TreeEntry> &tree : trees) treeEntries += tree.size();
+    return distances.size() * sizeof(double) + (points.size() + targetEntries.size()) * sizeof(int)
+           + treeEntries * sizeof(TreeEntry);
+}
+
+#endif
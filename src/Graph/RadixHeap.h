@@ -0,0 +1,133 @@
+#pragma once
+#ifndef RADIX_HEAP_H_
+#define RADIX_HEAP_H_
+
+#include <vector>
+#include <cstdint>
+#include <limits>
+
+using namespace std;
+
+/**
+ * Radix heap of vertex indexes, ordered by key[vertex], with the same interface as MutablePriorityQueue.
+ * It only works when the keys are never smaller than the last key extracted, which is the case of the distances
+ * of dijkstra (and of a* with a consistent heuristic).
+ *
+ * The buckets are chosen by the integer part of the keys: bucket 0 has the vertexes with the same integer part as
+ * the last key extracted, and bucket i the ones whose integer part first differs from it in bit i - 1. The vertex
+ * extracted is the one with the smallest exact key of bucket 0, so the order is the same as the binary heap's.
+ * When bucket 0 is empty, the first non empty bucket is spread through the buckets below it, so each vertex only
+ * moves a few times. decreaseKey adds the vertex again instead of moving it, and each copy keeps the key it was
+ * added with, so the old copies are discarded when they are found (their key is not the key of the vertex anymore,
+ * or the vertex was already extracted).
+ */
+class RadixHeap {
+    struct Entry {
+        double key;                 // key of the vertex when it was added
+        int vertex;
+    };
+
+    vector<Entry> buckets[65];
+    vector<Entry> spread;           // bucket being spread through the ones below it
+    uint64_t last = 0;              // integer part of the last key extracted
+    int size = 0;                   // number of vertexes in the heap (without the old copies)
+    const vector<double> &key;
+    vector<int> &queueIndex;
+
+    inline bool isOld(const Entry &entry) const;
+    inline int bucketOf(const double value) const;
+    inline void push(const Entry &entry);
+
+public:
+    RadixHeap(const vector<double> &key, vector<int> &queueIndex);
+    void insert(int x);
+    int extractMin();
+    void decreaseKey(int x);
+    bool empty();
+};
+
+RadixHeap::RadixHeap(const vector<double> &key, vector<int> &queueIndex) : key(key), queueIndex(queueIndex) {}
+
+/**
+ * @return - true if the entry is a copy left by decreaseKey or the vertex was already extracted
+ */
+bool RadixHeap::isOld(const Entry &entry) const {
+    return queueIndex[entry.vertex] == 0 || entry.key != key[entry.vertex];
+}
+
+/**
+ * @return - the bucket of a key: 0 if its integer part is equal to the last one extracted, otherwise 1 + the
+ * highest bit where they differ
+ */
+int RadixHeap::bucketOf(const double value) const {
+    uint64_t integer = (uint64_t) value;
+
+    // keys smaller than the last one (only possible with an inconsistent heuristic) are extracted as soon as possible
+    if(integer <= last) return 0;
+#if defined(__GNUC__)
+    return 64 - __builtin_clzll(integer ^ last);
+#else
+    int bucket = 0;
+    for(uint64_t difference = integer ^ last; difference != 0; difference >>= 1) bucket++;
+    return bucket;
+#endif
+}
+
+void RadixHeap::push(const Entry &entry) {
+    buckets[bucketOf(entry.key)].push_back(entry);
+}
+
+bool RadixHeap::empty() {
+    return size == 0;
+}
+
+void RadixHeap::insert(int x) {
+    queueIndex[x] = 1;
+    size++;
+    push({key[x], x});
+}
+
+void RadixHeap::decreaseKey(int x) {
+    push({key[x], x});
+}
+
+int RadixHeap::extractMin() {
+    while(true) {
+        vector<Entry> &first = buckets[0];
+
+        // the old copies are removed from bucket 0 while its smallest key is searched
+        int best = -1;
+        size_t kept = 0;
+        for(size_t i = 0; i < first.size(); i++) {
+            if(isOld(first[i])) continue;
+            if(best == -1 || first[i].key < first[best].key) best = kept;
+            first[kept++] = first[i];
+        }
+        first.resize(kept);
+
+        if(best != -1) {
+            int x = first[best].vertex;
+            first[best] = first.back();
+            first.pop_back();
+            queueIndex[x] = 0;
+            size--;
+            return x;
+        }
+
+        int i = 1;
+        while(buckets[i].empty()) i++;
+
+        // the smallest integer key of the bucket becomes the last one, and the bucket is spread through the ones below it
+        spread.swap(buckets[i]);
+        double minKey = numeric_limits<double>::infinity();
+        for(const Entry &entry : spread)
+            if(!isOld(entry) && entry.key < minKey) minKey = entry.key;
+        if(minKey != numeric_limits<double>::infinity()) last = (uint64_t) minKey;
+
+        for(const Entry &entry : spread)
+            if(!isOld(entry)) push(entry);
+        spread.clear();
+    }
+}
+
+#endif
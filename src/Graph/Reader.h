@@ -12,13 +12,20 @@ class Reader {
     public:
         Reader(const string &path) : path(path) {}
 
-        bool readGraph(Graph *graph, int &central);
-        bool readRequests(multiset<Request*> &requestVector);
+        bool readGraph(Graph *graph, int &central, const Graph::VertexOrder order = Graph::HILBERT_ORDER);
+        bool readRequests(multiset<Request*> &requestVector, Arena<Request> &requestArena);
         bool setTags(Graph *graph);
         bool setCentral(Graph *graph, int &central);
 };
 
-bool Reader::readGraph(Graph *graph, int &central) {
+/**
+ * @brief Reads the nodes and edges of the map into the graph
+ * @param graph - graph where the map is stored
+ * @param central - id of the central of the city
+ * @param order - how the vertexes are renumbered after being read (see Graph::reorderVertexes)
+ * @return - true if the files were read
+ */
+bool Reader::readGraph(Graph *graph, int &central, const Graph::VertexOrder order) {
     ifstream nodesStream(path + "/nodes.txt");
     ifstream edgesStream(path + "/edges.txt");
 
@@ -50,13 +57,19 @@ bool Reader::readGraph(Graph *graph, int &central) {
     nodesStream.close();
     edgesStream.close();
 
-    setTags(graph);
-    setCentral(graph, central);
+    graph->reorderVertexes(order);
 
-    return true;
+    setTags(graph);
+    return setCentral(graph, central);
 }
 
-bool Reader::readRequests(multiset<Request*> &requestVector) {
+/**
+ * @brief Reads the requests of the map
+ * @param requestVector - where the requests are inserted
+ * @param requestArena - arena that owns the requests created
+ * @return - true if the file was read
+ */
+bool Reader::readRequests(multiset<Request*> &requestVector, Arena<Request> &requestArena) {
     ifstream requests(path + "/requests.txt");
 
     if(!requests.is_open()) return false;
@@ -68,7 +81,7 @@ bool Reader::readRequests(multiset<Request*> &requestVector) {
     while(requests >> name) {
         requests >> dest >> priority >> hour >> min >> sec;
         Time arrival(hour, min, sec);
-        Request * request = new Request(name, dest, priority, arrival);
+        Request * request = requestArena.create(name, dest, priority, arrival);
         requestVector.insert(request);
     }
     return true;
@@ -96,7 +109,7 @@ bool Reader::setTags(Graph *graph) {
 bool Reader::setCentral(Graph *graph, int &central) {
     int pos = path.find_last_of('/');
     string city = path.substr(pos + 1);
-    Vertex *centralVertex;
+    Vertex *centralVertex = nullptr;
 
     if(city == "Porto") {
         centralVertex = graph->findVertex(90379359);
@@ -154,6 +167,9 @@ bool Reader::setCentral(Graph *graph, int &central) {
         central = ;
     }*/
 
+    // only the maps above have a central
+    if(centralVertex == nullptr) return false;
+
     graph->setOffsetX(centralVertex->getPosition().getX() - 300);
     graph->setOffsetY(centralVertex->getPosition().getY() - 250);
 
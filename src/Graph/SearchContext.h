@@ -0,0 +1,149 @@
+#pragma once
+#ifndef SEARCH_CONTEXT_H_
+#define SEARCH_CONTEXT_H_
+
+#include <vector>
+#include <limits>
+
+using namespace std;
+
+/**
+ * State of a shortest path search, stored in arrays indexed by the index of the vertexes.
+ * Since the searches only read the graph and write to their own context, several threads can
+ * run searches over the same graph at the same time, each one with its own SearchContext.
+ * The fields with "inv" in the name are the ones used by the backward search of dijkstraBidirectional.
+ *
+ * Instead of resetting every vertex before each search, every search gets a new generation number and
+ * the fields of a vertex are only reset the first time the search touches it (when its stamp is from an
+ * older generation). This way the cost of a search depends on the vertexes it reaches, not on the graph size.
+ */
+class SearchContext {
+private:
+    vector<double> dist;                // distance from the start vertex
+    vector<double> invDist;             // distance to the final vertex (backward search)
+    vector<int> path;                   // index of the vertex that leads to each vertex (-1 if there is none)
+    vector<int> invPath;
+    vector<int> edgePath;               // csr arc used to reach each vertex (-1 if there is none)
+    vector<int> invEdgePath;
+    vector<double> heuristicValue;      // oriented search optimization (a*)
+    vector<double> invHeuristicValue;
+    vector<int> queueIndex;             // required by MutablePriorityQueue
+    vector<int> invQueueIndex;
+    vector<char> visited;
+    vector<char> invVisited;
+
+    vector<unsigned> stamp;             // generation of the search that last touched each vertex
+    unsigned generation = 0;            // generation of the current search
+
+    void reset(const int vertex);
+    inline void touch(const int vertex);
+    bool isTouched(const int vertex) const;
+
+    const static int infinite = 99999999;
+
+public:
+    SearchContext() {}
+    SearchContext(const int numVertex) {
+        init(numVertex);
+    }
+
+    void init(const int numVertex);
+    void newSearch(const int numVertex);
+
+    int getNumVertex() const;
+    double getDist(const int vertex) const;
+    int getPath(const int vertex) const;
+    int getEdgePath(const int vertex) const;
+    bool getVisited(const int vertex) const;
+
+    friend class Graph;
+    friend class ContractionHierarchy;
+    friend class CustomizableContractionHierarchy;
+};
+
+/**
+ * @brief Sets every field of every vertex to its default value, resizing the arrays if needed
+ * @param numVertex - number of vertexes of the graph that will be searched
+ */
+void SearchContext::init(const int numVertex) {
+    dist.assign(numVertex, infinite);
+    invDist.assign(numVertex, infinite);
+    path.assign(numVertex, -1);
+    invPath.assign(numVertex, -1);
+    edgePath.assign(numVertex, -1);
+    invEdgePath.assign(numVertex, -1);
+    heuristicValue.assign(numVertex, infinite);
+    invHeuristicValue.assign(numVertex, infinite);
+    queueIndex.assign(numVertex, 0);
+    invQueueIndex.assign(numVertex, 0);
+    visited.assign(numVertex, false);
+    invVisited.assign(numVertex, false);
+    stamp.assign(numVertex, 0);
+    generation = 0;
+}
+
+/**
+ * @brief Starts a new search. Only when the graph size changed (or the generation counter overflows)
+ * the arrays are reset, otherwise this takes constant time
+ * @param numVertex - number of vertexes of the graph that will be searched
+ */
+void SearchContext::newSearch(const int numVertex) {
+    if(numVertex != getNumVertex() || generation == numeric_limits<unsigned>::max())
+        init(numVertex);
+    generation++;
+}
+
+/**
+ * @brief Sets the fields of a vertex to their default value
+ * @param vertex - index of the vertex
+ */
+void SearchContext::reset(const int vertex) {
+    dist[vertex] = infinite;
+    invDist[vertex] = infinite;
+    path[vertex] = -1;
+    invPath[vertex] = -1;
+    edgePath[vertex] = -1;
+    invEdgePath[vertex] = -1;
+    heuristicValue[vertex] = infinite;
+    invHeuristicValue[vertex] = infinite;
+    queueIndex[vertex] = 0;
+    invQueueIndex[vertex] = 0;
+    visited[vertex] = false;
+    invVisited[vertex] = false;
+    stamp[vertex] = generation;
+}
+
+/**
+ * @brief Must be called before reading the fields of a vertex in a search, resets them if they are
+ * from an older search
+ * @param vertex - index of the vertex
+ */
+void SearchContext::touch(const int vertex) {
+    if(stamp[vertex] != generation) reset(vertex);
+}
+
+bool SearchContext::isTouched(const int vertex) const {
+    return vertex < getNumVertex() && stamp[vertex] == generation;
+}
+
+int SearchContext::getNumVertex() const {
+    return dist.size();
+}
+
+double SearchContext::getDist(const int vertex) const {
+    return isTouched(vertex) ? dist[vertex] : infinite;
+}
+
+int SearchContext::getPath(const int vertex) const {
+    return isTouched(vertex) ? path[vertex] : -1;
+}
+
+int SearchContext::getEdgePath(const int vertex) const {
+    return isTouched(vertex) ? edgePath[vertex] : -1;
+}
+
+bool SearchContext::getVisited(const int vertex) const {
+    return isTouched(vertex) && visited[vertex];
+}
+
+#endif
@@ -0,0 +1,281 @@
+#pragma once
+#ifndef SHORTEST_PATH_TREE_H_
+#define SHORTEST_PATH_TREE_H_
+
+#include <vector>
+#include <string>
+#include <fstream>
+#include <cstdint>
+#include <cstring>
+#include "SearchContext.h"
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+using namespace std;
+
+/**
+ * Shortest path tree of a vertex (usually the central): the distance from the root to every vertex and the
+ * vertex and arc that lead to it, indexed by the index of the vertexes.
+ * The tree is kept in a single block with the same layout as its file (a header followed by the arrays), so saving
+ * it writes the block and loading it maps the file into memory (reads it on Windows) without converting anything.
+ * The file stores a checksum of the graph it was computed on, so a file of a different graph (or of the same map
+ * before being pre processed) is never used, and a checksum of its arrays, which are also checked to form a tree
+ * with indexes inside the graph, so a damaged file is never used either.
+ */
+class ShortestPathTree {
+private:
+    struct Header {
+        char magic[4];              // "SPT2"
+        int32_t numVertex;
+        int32_t root;               // index of the root
+        int32_t numArcs;            // number of arcs of the csr the arcs of the tree belong to
+        uint64_t checksum;          // checksum of the graph the tree was computed on
+        uint64_t arraysChecksum;    // checksum of the arrays after the header
+    };
+
+    vector<char> buffer;            // block of a tree computed or read, empty if the block is a mapped file
+    void *mapping = nullptr;        // block of a mapped file
+    size_t mappingSize = 0;
+
+    const Header *header = nullptr;
+    const double *dist = nullptr;   // distance from the root
+    const int32_t *path = nullptr;  // index of the vertex that leads to each vertex (-1 if there is none)
+    const int32_t *edgePath = nullptr;          // csr arc used to reach each vertex (-1 if there is none)
+
+    static size_t blockSize(const int numVertex);
+    static uint64_t arraysChecksum(const char *block, const size_t size);
+    bool setBlock(const char *block, const size_t size);
+    bool isTree() const;
+    void release();
+
+public:
+    ShortestPathTree() {}
+    ShortestPathTree(const ShortestPathTree &) = delete;
+    ShortestPathTree &operator=(const ShortestPathTree &) = delete;
+    ~ShortestPathTree() {
+        release();
+    }
+
+    void build(const SearchContext &context, const int root, const int numArcs, const uint64_t checksum);
+    bool save(const string &file) const;
+    bool load(const string &file, const int root, const int numVertex, const int numArcs, const uint64_t checksum);
+
+    bool empty() const;
+    int getRoot() const;
+    int getNumVertex() const;
+    uint64_t getChecksum() const;
+    double getDist(const int vertex) const;
+    int getPath(const int vertex) const;
+    int getEdgePath(const int vertex) const;
+};
+
+/**
+ * @return - the size of the block of a tree with that many vertexes
+ */
+size_t ShortestPathTree::blockSize(const int numVertex) {
+    return sizeof(Header) + (size_t) numVertex * (sizeof(double) + 2 * sizeof(int32_t));
+}
+
+/**
+ * @return - the checksum of the arrays of a block (everything after the header)
+ */
+uint64_t ShortestPathTree::arraysChecksum(const char *block, const size_t size) {
+    uint64_t hash = 14695981039346656037ULL;
+    for(size_t i = sizeof(Header); i < size; i++) {
+        hash ^= (unsigned char) block[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+/**
+ * @brief Points the arrays to a block, if its header is valid and its size and arrays match it
+ * @return - true if the block is valid
+ */
+bool ShortestPathTree::setBlock(const char *block, const size_t size) {
+    if(size < sizeof(Header)) return false;
+    const Header *blockHeader = (const Header *) block;
+    if(memcmp(blockHeader->magic, "SPT2", 4) != 0 || blockHeader->numVertex < 0 || size != blockSize(blockHeader->numVertex))
+        return false;
+    if(blockHeader->arraysChecksum != arraysChecksum(block, size)) return false;
+
+    header = blockHeader;
+    dist = (const double *) (block + sizeof(Header));
+    path = (const int32_t *) (dist + header->numVertex);
+    edgePath = path + header->numVertex;
+    return true;
+}
+
+/**
+ * @brief Checks that the arrays can be followed safely: the root is a vertex without a parent, every parent is a
+ * vertex or -1, every vertex with a parent has an arc of the csr, and following the parents never loops
+ * @return - true if the arrays form a tree
+ */
+bool ShortestPathTree::isTree() const {
+    int numVertex = header->numVertex;
+    if(header->root < 0 || header->root >= numVertex || path[header->root] != -1) return false;
+
+    for(int vertex = 0; vertex < numVertex; vertex++) {
+        if(path[vertex] < -1 || path[vertex] >= numVertex) return false;
+        if(path[vertex] != -1 && (edgePath[vertex] < 0 || edgePath[vertex] >= header->numArcs)) return false;
+    }
+
+    // each vertex is followed up to a vertex without a parent or already checked, a vertex seen twice is a loop
+    vector<char> state(numVertex, 0);       // 0 not checked, 1 in the current chain, 2 checked
+    for(int vertex = 0; vertex < numVertex; vertex++) {
+        int current = vertex;
+        while(current != -1 && state[current] == 0) {
+            state[current] = 1;
+            current = path[current];
+        }
+        if(current != -1 && state[current] == 1) return false;
+
+        for(current = vertex; current != -1 && state[current] == 1; current = path[current])
+            state[current] = 2;
+    }
+    return true;
+}
+
+/**
+ * @brief Releases the block of the tree, which becomes empty
+ */
+void ShortestPathTree::release() {
+#ifndef _WIN32
+    if(mapping != nullptr) munmap(mapping, mappingSize);
+#endif
+    mapping = nullptr;
+    mappingSize = 0;
+    vector<char>().swap(buffer);
+    header = nullptr;
+    dist = nullptr;
+    path = edgePath = nullptr;
+}
+
+/**
+ * @brief Copies the tree of a finished search into the block
+ * @param context - search context of a search that ran until the queue was empty
+ * @param root - index of the vertex where the search started
+ * @param numArcs - number of arcs of the csr that was searched
+ * @param checksum - checksum of the graph that was searched
+ */
+void ShortestPathTree::build(const SearchContext &context, const int root, const int numArcs, const uint64_t checksum) {
+    release();
+    int numVertex = context.getNumVertex();
+    buffer.assign(blockSize(numVertex), 0);
+
+    Header *blockHeader = (Header *) buffer.data();
+    memcpy(blockHeader->magic, "SPT2", 4);
+    blockHeader->numVertex = numVertex;
+    blockHeader->root = root;
+    blockHeader->numArcs = numArcs;
+    blockHeader->checksum = checksum;
+
+    double *blockDist = (double *) (buffer.data() + sizeof(Header));
+    int32_t *blockPath = (int32_t *) (blockDist + numVertex);
+    int32_t *blockEdgePath = blockPath + numVertex;
+    for(int vertex = 0; vertex < numVertex; vertex++) {
+        blockDist[vertex] = context.getDist(vertex);
+        blockPath[vertex] = context.getPath(vertex);
+        blockEdgePath[vertex] = context.getEdgePath(vertex);
+    }
+
+    blockHeader->arraysChecksum = arraysChecksum(buffer.data(), buffer.size());
+    setBlock(buffer.data(), buffer.size());
+}
+
+/**
+ * @brief Writes the block of the tree to a file
+ * @param file - path of the file
+ * @return - true if the file was written
+ */
+bool ShortestPathTree::save(const string &file) const {
+    if(empty()) return false;
+
+    ofstream stream(file, ios::binary | ios::trunc);
+    if(!stream.is_open()) return false;
+    stream.write((const char *) header, blockSize(header->numVertex));
+    return stream.good();
+}
+
+/**
+ * @brief Maps a file written by save into memory (on Windows the file is read instead) and checks it
+ * @param file - path of the file
+ * @param root - index of the root the tree must have
+ * @param numVertex - number of vertexes the tree must have
+ * @param numArcs - number of arcs of the csr the tree must have been computed on
+ * @param checksum - checksum of the graph the tree must have been computed on
+ * @return - true if the file exists, is intact and has the tree of that root in that graph, otherwise the tree is empty
+ */
+bool ShortestPathTree::load(const string &file, const int root, const int numVertex, const int numArcs, const uint64_t checksum) {
+    release();
+
+#ifdef _WIN32
+    ifstream stream(file, ios::binary | ios::ate);
+    if(!stream.is_open()) return false;
+    buffer.resize(stream.tellg());
+    stream.seekg(0);
+    if(!stream.read(buffer.data(), buffer.size()) || !setBlock(buffer.data(), buffer.size())) {
+        release();
+        return false;
+    }
+#else
+    int descriptor = open(file.c_str(), O_RDONLY);
+    if(descriptor == -1) return false;
+
+    struct stat status;
+    if(fstat(descriptor, &status) == 0 && status.st_size > 0) {
+        void *block = mmap(nullptr, status.st_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        if(block != MAP_FAILED) {
+            mapping = block;
+            mappingSize = status.st_size;
+        }
+    }
+    close(descriptor);
+
+    if(mapping == nullptr || !setBlock((const char *) mapping, mappingSize)) {
+        release();
+        return false;
+    }
+#endif
+
+    if(header->root != root || header->numVertex != numVertex || header->numArcs != numArcs || header->checksum != checksum || !isTree()) {
+        release();
+        return false;
+    }
+    return true;
+}
+
+bool ShortestPathTree::empty() const {
+    return header == nullptr;
+}
+
+int ShortestPathTree::getRoot() const {
+    return empty() ? -1 : header->root;
+}
+
+int ShortestPathTree::getNumVertex() const {
+    return empty() ? 0 : header->numVertex;
+}
+
+uint64_t ShortestPathTree::getChecksum() const {
+    return empty() ? 0 : header->checksum;
+}
+
+double ShortestPathTree::getDist(const int vertex) const {
+    return dist[vertex];
+}
+
+int ShortestPathTree::getPath(const int vertex) const {
+    return path[vertex];
+}
+
+int ShortestPathTree::getEdgePath(const int vertex) const {
+    return edgePath[vertex];
+}
+
+#endif
@@ -0,0 +1,336 @@
+#pragma once
+#ifndef TASK_SCHEDULER_H_
+#define TASK_SCHEDULER_H_
+
+#include <vector>
+#include <deque>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <algorithm>
+
+using namespace std;
+
+/**
+ * Work stealing scheduler: a fixed set of worker threads, each one with its own deque of tasks.
+ * A worker pushes the tasks it creates to the back of its deque and takes its next task from the back too, so it
+ * keeps working on the data it just touched. A worker with an empty deque steals from the front of the deque of
+ * another worker, which takes the oldest (and usually biggest) task, so the work spreads with few steals.
+ * The tasks created outside the workers are spread through the deques in turn.
+ *
+ * The tasks are grouped by TaskGroup (fork and join): a worker that waits for a group runs other tasks meanwhile,
+ * so groups can be nested inside tasks without blocking the workers. parallelFor is built on top of it.
+ * With a single worker no thread is created and every task runs as soon as it is created, on the thread that creates it.
+ */
+class TaskScheduler {
+private:
+    struct Worker {
+        mutex lock;
+        deque<function<void()>> tasks;
+    };
+
+    vector<unique_ptr<Worker>> workers;
+    vector<thread> threads;
+    atomic<int> queued{0};          // tasks waiting in the deques
+    atomic<unsigned> nextWorker{0}; // deque where the next task created outside the workers goes
+    mutex sleepLock;
+    condition_variable wake;
+    bool stopping = false;
+
+    static thread_local TaskScheduler *currentScheduler;
+    static thread_local int currentWorker;
+
+    void work(const int worker);
+    bool pop(const int worker, function<void()> &task);
+
+public:
+    TaskScheduler(const int numWorkers = 0);
+    TaskScheduler(const TaskScheduler &) = delete;
+    TaskScheduler &operator=(const TaskScheduler &) = delete;
+    ~TaskScheduler();
+
+    static TaskScheduler &shared();
+
+    int getNumWorkers() const;
+    int getCurrentWorker() const;
+    bool isWorker() const;
+    bool isInline() const;
+    void push(function<void()> task);
+    bool runOne();
+    void sleepUntil(const function<bool()> &finished);
+    void wakeAll();
+    void parallelFor(const int count, const function<void(int, int)> &body, const int grain = 1);
+};
+
+/**
+ * Set of tasks that can be waited for together (fork and join)
+ */
+class TaskGroup {
+private:
+    TaskScheduler &scheduler;
+    int pending = 0;                // tasks of the group that didn't finish yet
+    mutex lock;
+    condition_variable done;
+
+public:
+    TaskGroup(TaskScheduler &scheduler) : scheduler(scheduler) {}
+    TaskGroup(const TaskGroup &) = delete;
+    TaskGroup &operator=(const TaskGroup &) = delete;
+    ~TaskGroup() {
+        wait();
+    }
+
+    void run(function<void()> task);
+    void wait();
+};
+
+thread_local TaskScheduler *TaskScheduler::currentScheduler = nullptr;
+thread_local int TaskScheduler::currentWorker = -1;
+
+/**
+ * @param numWorkers - number of workers, 0 to use one per core of the machine
+ */
+TaskScheduler::TaskScheduler(const int numWorkers) {
+    int count = numWorkers > 0 ? numWorkers : max(1u, thread::hardware_concurrency());
+    for(int worker = 0; worker < count; worker++)
+        workers.emplace_back(new Worker());
+
+    if(count > 1)
+        for(int worker = 0; worker < count; worker++)
+            threads.emplace_back(&TaskScheduler::work, this, worker);
+}
+
+TaskScheduler::~TaskScheduler() {
+    {
+        lock_guard<mutex> lock(sleepLock);
+        stopping = true;
+    }
+    wake.notify_all();
+    for(thread &t : threads) t.join();
+}
+
+/**
+ * @return - the scheduler shared by the whole program, with one worker per core
+ */
+TaskScheduler &TaskScheduler::shared() {
+    static TaskScheduler scheduler;
+    return scheduler;
+}
+
+/**
+ * @brief Loop of each worker thread: runs tasks while there are any, and sleeps when there are none
+ * @param worker - number of the worker
+ */
+void TaskScheduler::work(const int worker) {
+    currentScheduler = this;
+    currentWorker = worker;
+
+    function<void()> task;
+    while(true) {
+        if(pop(worker, task)) {
+            task();
+            continue;
+        }
+
+        unique_lock<mutex> lock(sleepLock);
+        wake.wait(lock, [&]() { return stopping || queued > 0; });
+        if(stopping) return;
+    }
+}
+
+/**
+ * @brief Takes the last task of the deque of the worker or, if it is empty, the first task of another deque
+ * @param worker - number of the worker looking for a task
+ * @param task - set to the task taken
+ * @return - true if a task was taken
+ */
+bool TaskScheduler::pop(const int worker, function<void()> &task) {
+    if(queued == 0) return false;
+    int numWorkers = workers.size();
+
+    {
+        Worker &own = *workers[worker];
+        lock_guard<mutex> lock(own.lock);
+        if(!own.tasks.empty()) {
+            task = move(own.tasks.back());
+            own.tasks.pop_back();
+            queued--;
+            return true;
+        }
+    }
+
+    for(int i = 1; i < numWorkers; i++) {
+        Worker &victim = *workers[(worker + i) % numWorkers];
+        lock_guard<mutex> lock(victim.lock);
+        if(!victim.tasks.empty()) {
+            task = move(victim.tasks.front());
+            victim.tasks.pop_front();
+            queued--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+int TaskScheduler::getNumWorkers() const {
+    return workers.size();
+}
+
+/**
+ * @return - the number of the worker running the calling thread, 0 outside the workers (where tasks only run
+ * when there are no threads)
+ */
+int TaskScheduler::getCurrentWorker() const {
+    return currentScheduler == this ? currentWorker : 0;
+}
+
+/**
+ * @return - true if the calling thread is one of the worker threads of the scheduler
+ */
+bool TaskScheduler::isWorker() const {
+    return currentScheduler == this;
+}
+
+/**
+ * @return - true if the scheduler has a single worker, so the tasks run as soon as they are created
+ */
+bool TaskScheduler::isInline() const {
+    return threads.empty();
+}
+
+/**
+ * @brief Adds a task to the deque of the calling worker (or of the next worker, if it isn't one of them)
+ * @param task - the task
+ */
+void TaskScheduler::push(function<void()> task) {
+    if(isInline()) {
+        task();
+        return;
+    }
+
+    int worker = currentScheduler == this ? currentWorker : nextWorker++ % workers.size();
+    {
+        lock_guard<mutex> lock(workers[worker]->lock);
+        workers[worker]->tasks.push_back(move(task));
+    }
+    queued++;
+
+    // taking the lock makes sure a worker that saw no tasks is already waiting, so it gets woken up
+    { lock_guard<mutex> lock(sleepLock); }
+    wake.notify_one();
+}
+
+/**
+ * @brief Runs one task in the calling worker, used by the workers while they wait for a group
+ * @return - true if there was a task to run
+ */
+bool TaskScheduler::runOne() {
+    if(currentScheduler != this) return false;
+
+    function<void()> task;
+    if(!pop(currentWorker, task)) return false;
+    task();
+    return true;
+}
+
+/**
+ * @brief Puts the calling worker to sleep until a task is created or something it waits for is finished,
+ * which must be followed by wakeAll
+ * @param finished - returns true when what the worker waits for is finished
+ */
+void TaskScheduler::sleepUntil(const function<bool()> &finished) {
+    unique_lock<mutex> lock(sleepLock);
+    wake.wait(lock, [&]() { return queued > 0 || finished(); });
+}
+
+/**
+ * @brief Wakes up every sleeping worker, so the ones in sleepUntil check again what they wait for
+ */
+void TaskScheduler::wakeAll() {
+    { lock_guard<mutex> lock(sleepLock); }
+    wake.notify_all();
+}
+
+/**
+ * @brief Runs a function for every item from 0 to count - 1 and returns when all of them are done.
+ * The range is split in half recursively, each half becoming a task, so idle workers steal big ranges
+ * @param count - number of items
+ * @param body - function called with each item and the worker (from 0 to getNumWorkers() - 1) running it.
+ * It can't change anything used by the other items, except what belongs to its worker. If it waits for other tasks
+ * (a nested parallelFor), other items may run in its worker meanwhile
+ * @param grain - ranges with this many items or less aren't split again
+ */
+void TaskScheduler::parallelFor(const int count, const function<void(int, int)> &body, const int grain) {
+    if(count <= 0) return;
+    if(isInline()) {
+        for(int item = 0; item < count; item++) body(item, 0);
+        return;
+    }
+
+    TaskGroup group(*this);
+    function<void(int, int)> split = [&](int begin, int end) {
+        while(end - begin > max(1, grain)) {
+            int middle = begin + (end - begin) / 2;
+            group.run([&split, middle, end]() { split(middle, end); });
+            end = middle;
+        }
+
+        int worker = getCurrentWorker();
+        for(int item = begin; item < end; item++) body(item, worker);
+    };
+
+    // the whole range is a task too, so the body always runs in a worker
+    group.run([&split, count]() { split(0, count); });
+    group.wait();
+}
+
+/**
+ * @brief Creates a task of the group
+ * @param task - the task
+ */
+void TaskGroup::run(function<void()> task) {
+    {
+        lock_guard<mutex> guard(lock);
+        pending++;
+    }
+
+    TaskScheduler *owner = &scheduler;
+    scheduler.push([this, owner, task]() {
+        task();
+        {
+            lock_guard<mutex> guard(lock);
+            if(--pending > 0) return;
+            done.notify_all();
+        }
+
+        // the group can be gone as soon as its lock is released, so only the scheduler is used from here
+        owner->wakeAll();
+    });
+}
+
+/**
+ * @brief Returns when every task of the group is done. A worker runs other tasks while it waits, and sleeps when
+ * there are none until one is created or the group is done. Any other thread just sleeps until the group is done
+ */
+void TaskGroup::wait() {
+    if(!scheduler.isWorker()) {
+        unique_lock<mutex> guard(lock);
+        done.wait(guard, [&]() { return pending == 0; });
+        return;
+    }
+
+    function<bool()> finished = [&]() {
+        lock_guard<mutex> guard(lock);
+        return pending == 0;
+    };
+    while(!finished()) {
+        // nothing to run: the remaining tasks of the group are running in other workers
+        if(!scheduler.runOne()) scheduler.sleepUntil(finished);
+    }
+}
+
+#endif
@@ -13,32 +13,13 @@ public:
 
 private:
     int id;                            // identifier of the vertex
+    int index = -1;                    // position of the vertex in the graph (used by the CSR arrays)
     Position pos;			           // content of the vertex
     vector<Edge> adj;		           // outgoing edges
     vector<Edge> invAdj;               // ingoing edges
     Tag tag = DEFAULT;                 // vertex Tag
-    double dist = infinite;
-    double distCentral = infinite;
-    double invDist = infinite;
-    // central path
-    Vertex *pathCentral = nullptr;
-    Edge edgePathCentral;
-    // others path
-    Vertex *path = nullptr;
-    Vertex *invPath = nullptr;
-    Edge edgePath;
-    Edge invEdgePath;
-    bool inv = false;
-
-    int queueIndex = 0; 		    // required by MutablePriorityQueue
-    double heuristicValue = 0;      // oriented search optimization (a*)
-    double invHeuristicValue = 0;
-    int invQueueIndex = 0;
-    bool invVisited = false;
-    bool visited = false;		      // auxiliary field
 
     void addEdge(const int &id, Vertex *dest, const double &weight);
-    const static int infinite = 99999999;
 
 public:
     Vertex(const int &id, const int &x, const int &y) {
@@ -48,19 +29,15 @@ public:
 
     /* get methods */
     int getId() const;
-    Position getPosition() const;
-    vector<Edge> getAdj() const;
-    vector<Edge> getInvAdj() const;
-    double getDist() const;
-    Vertex *getPath() const;
-    Edge getEdgePath() const;
-    bool getVisited() const;
+    const Position &getPosition() const;
+    const vector<Edge> &getAdj() const;
+    const vector<Edge> &getInvAdj() const;
+    int getIndex() const;
     Tag getTag() const;
     void setTag(Vertex::Tag tag);
 
-    bool operator<(Vertex &vertex) const; //required by MutablePriorityQueue
     friend class Graph;
-    friend class MutablePriorityQueue<Vertex>;
+    friend class CSRGraph;
 };
 
 /**
@@ -77,32 +54,20 @@ int Vertex::getId() const {
     return this->id;
 }
 
-Position Vertex::getPosition() const {
+const Position &Vertex::getPosition() const {
     return this->pos;
 }
 
-vector<Edge> Vertex::getAdj() const {
+const vector<Edge> &Vertex::getAdj() const {
     return this->adj;
 }
 
-vector<Edge> Vertex::getInvAdj() const {
+const vector<Edge> &Vertex::getInvAdj() const {
     return this->invAdj;
 }
 
-double Vertex::getDist() const {
-    return this->dist;
-}
-
-Vertex* Vertex::getPath() const {
-    return this->path;
-}
-
-Edge Vertex::getEdgePath() const {
-    return this->edgePath;
-}
-
-bool Vertex::getVisited() const {
-    return this->visited;
+int Vertex::getIndex() const {
+    return this->index;
 }
 
 Vertex::Tag Vertex::getTag() const {
@@ -113,18 +78,4 @@ void Vertex::setTag(Vertex::Tag tag) {
     this->tag = tag;
 }
 
-bool Vertex::operator<(Vertex &vertex) const {
-
-    if(heuristicValue != infinite)
-        return this->heuristicValue < vertex.heuristicValue;
-
-    if(invHeuristicValue != infinite)
-        return this->invHeuristicValue < vertex.invHeuristicValue;
-
-    if(invDist != infinite)
-        return this->invDist < vertex.invDist;
-
-    return this->dist < vertex.dist;
-}
-
 #endif
\ No newline at end of file
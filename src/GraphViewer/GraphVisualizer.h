@@ -11,6 +11,7 @@ private:
     bool isActive = true;
     int width, height;
     GraphViewer *gv;
+    thread drawThread;          // last drawing started from a thread (see join)
 
 public:
     GraphVisualizer(const int width, const int height) {
@@ -19,7 +20,10 @@ public:
         this->gv = new GraphViewer(1, 1, false);
     }
 
+    GraphVisualizer(const GraphVisualizer &visualizer) = delete;
+    GraphVisualizer &operator=(const GraphVisualizer &visualizer) = delete;
     ~GraphVisualizer() {
+        join();
         delete gv;
     }
 	
@@ -27,6 +31,7 @@ public:
     void setStatus(bool status);
     GraphViewer* getViewer() const;
     void drawFromThread(Graph *graph);
+    void join();
     void draw(Graph *graph);
     void setPath(const vector<int> &edges, const string &edgeColor, const bool isShortestPath = false);
     void setNode(const int id, const int size, const string color, const string label);
@@ -50,9 +55,17 @@ GraphViewer* GraphVisualizer::getViewer() const {
 
 void GraphVisualizer::drawFromThread(Graph *graph) {
 	if(!isActive) return;
+    join();
     newGv();
-    thread threadProcess(&GraphVisualizer::draw, this, graph);
-    threadProcess.detach();
+    drawThread = thread(&GraphVisualizer::draw, this, graph);
+}
+
+/**
+ * @brief Waits for the drawing started from a thread to finish. It reads the graph, so the graph can only be changed
+ * or deleted after this
+ */
+void GraphVisualizer::join() {
+    if(drawThread.joinable()) drawThread.join();
 }
 
 void GraphVisualizer::draw(Graph *graph) {
@@ -62,7 +75,7 @@ void GraphVisualizer::draw(Graph *graph) {
     this->gv->defineEdgeColor("gray");
     this->gv->defineEdgeCurved(false);
 
-    vector<Vertex*> vertexSet = graph->getVertexSet();
+    const vector<Vertex*> &vertexSet = graph->getVertexSet();
 
     for(Vertex *origin : vertexSet)
         this->gv->addNode(origin->getId(), origin->getPosition().getX() - graph->getOffsetX(), origin->getPosition().getY() - graph->getOffsetY());
@@ -95,7 +108,7 @@ void GraphVisualizer::draw(Graph *graph) {
             this->gv->setVertexSize(origin->getId(), 5);
         }
 
-        for(Edge e : origin->getAdj()) {
+        for(const Edge &e : origin->getAdj()) {
             this->gv->addEdge(e.getId(), origin->getId(), e.getDest()->getId(), EdgeType::UNDIRECTED);
         }
     }
@@ -119,9 +132,9 @@ void GraphVisualizer::setNode(const int id, const int size, const string color,
 }
 
 void GraphVisualizer::drawShortestPathFromThread(const unordered_set<int> &processedEdges, const unordered_set<int> &processedEdgesInv, const vector<Edge> &edges, Graph *graph) {
+    join();
     newGv();
-    thread threadProcess(&GraphVisualizer::drawShortestPath, this, processedEdges, processedEdgesInv, edges, graph);
-    threadProcess.detach();
+    drawThread = thread(&GraphVisualizer::drawShortestPath, this, processedEdges, processedEdgesInv, edges, graph);
 }
 
 void GraphVisualizer::drawShortestPath(const unordered_set<int> &processedEdges, const unordered_set<int> &processedEdgesInv, const vector<Edge> &edges, Graph *graph) {
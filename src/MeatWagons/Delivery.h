@@ -22,8 +22,8 @@ class Delivery {
 
         Time getStart() const;
         Time getEnd() const;
-        vector<Request*> getRequests() const;
-        vector<Edge> getForwardPath() const;
+        const vector<Request*> &getRequests() const;
+        const vector<Edge> &getForwardPath() const;
         int getDropOff() const;
         int getTotalDist() const;
 };
@@ -40,11 +40,11 @@ int Delivery::getTotalDist() const {
     return this->totalDist;
 }
 
-vector<Request*> Delivery::getRequests() const {
+const vector<Request*> &Delivery::getRequests() const {
     return this->requests;
 }
 
-vector<Edge> Delivery::getForwardPath() const {
+const vector<Edge> &Delivery::getForwardPath() const {
     return this->forwardPath;
 }
 
@@ -19,15 +19,22 @@ class MeatWagons {
     private:
         int central;
         Graph *graph = nullptr;
+        Arena<Request> requestArena;            // owns the requests of the current map
+        Arena<Delivery> deliveryArena{256};     // owns the deliveries of the last dispatch
         vector<Vertex*> pointsOfInterest;
         string graphName;
+        string graphPath;
         multiset<Wagon> wagons;
         multiset<Request*> requests;
         multiset<Request*> constantRequests;
+        PoiMatrix dispatchMatrix;               // paths between the central and the points of interest
         int zoneMaxDist;
         bool processed = false;
+        thread deliveriesThread;                // last drawing of a delivery started from a thread
         const static int averageVelocity = 9;
 
+        void joinDrawing();
+
     public:
         GraphVisualizer *viewer = new GraphVisualizer(600, 600);
         MeatWagons(const int wagons) {
@@ -36,6 +43,14 @@ class MeatWagons {
             }
             this->zoneMaxDist = 2000;
         }
+        MeatWagons(const MeatWagons &meatWagons) = delete;
+        MeatWagons &operator=(const MeatWagons &meatWagons) = delete;
+        ~MeatWagons() {
+            // the drawing threads may still be reading the graph
+            joinDrawing();
+            delete this->viewer;
+            delete this->graph;
+        }
 
         int getCentral() const;
         bool setCentral(const int &id);
@@ -44,17 +59,21 @@ class MeatWagons {
         void setMaxDist(const int max);
         void setWagons(const int n, const int capacity);
         Graph* getGraph() const;
-        multiset<Wagon> getWagons() const;
+        const multiset<Wagon> &getWagons() const;
         void addWagon(const int capacity);
         void removeWagon(const int id);
-        multiset<Request*> getRequests() const;
-        multiset<Request*> getConstantRequests() const;
+        const multiset<Request*> &getRequests() const;
+        const multiset<Request*> &getConstantRequests() const;
 
         bool setGraph(const string path);
         bool preProcess(const int node, const bool draw);
+        bool updateCentralTree();
         bool shortestPath(const int option, const int origin, const int dest);
         multiset<Wagon>::iterator getWagon();
 
+        void resetWagons();
+        bool buildDispatchMatrix();
+        double roadDistance(Vertex *origin, Vertex *dest) const;
         bool deliver(const int iteration);
         int chooseDropOff(const vector<Vertex*> &pickupNodes);
         vector<Request*> groupRequests(const int capacity);
@@ -80,6 +99,9 @@ int MeatWagons::getCentral() const {
 bool MeatWagons::setCentral(const int &id) {
     if(this->graph->findVertex(id) == nullptr) return false;
     this->central = id;
+
+    // the paths from the central are only used after the graph is pre processed
+    if(this->processed) return updateCentralTree();
     return true;
 }
 
@@ -99,7 +121,7 @@ Graph* MeatWagons::getGraph() const {
     return this->graph;
 }
 
-multiset<Wagon> MeatWagons::getWagons() const {
+const multiset<Wagon> &MeatWagons::getWagons() const {
     return this->wagons;
 }
 
@@ -122,11 +144,11 @@ void MeatWagons::removeWagon(const int id) {
         }
 }
 
-multiset<Request*> MeatWagons::getRequests() const {
+const multiset<Request*> &MeatWagons::getRequests() const {
     return this->requests;
 }
 
-multiset<Request*> MeatWagons::getConstantRequests() const {
+const multiset<Request*> &MeatWagons::getConstantRequests() const {
     return this->constantRequests;
 }
 
@@ -135,18 +157,35 @@ multiset<Request*> MeatWagons::getConstantRequests() const {
  * @return true upon success
  */
 bool MeatWagons::setGraph(const string graphPath) {
+    // the new map is read aside, so the current one is kept if any of its files can't be read
     Reader graphReader = Reader(graphPath);
     Graph* graphRead = new Graph();
+    Arena<Request> requestArenaRead;
+    multiset<Request*> requestsRead;
 
-    if(!graphReader.readGraph(graphRead, central))
+    int centralRead;
+    if(!graphReader.readGraph(graphRead, centralRead) || !graphReader.readRequests(requestsRead, requestArenaRead)) {
+        delete graphRead;
         return false;
-    if(!graphReader.readRequests(requests))
-        return false;
-    
+    }
+
+    // everything that belongs to the previous map is released: its deliveries, requests and graph
+    joinDrawing();
+    resetWagons();
+    this->deliveryArena.clear();
+    this->constantRequests.clear();
+    this->pointsOfInterest.clear();
+    this->dispatchMatrix.clear();
+    this->requests.swap(requestsRead);
+    this->requestArena.swap(requestArenaRead);
+    delete this->graph;
+
+    this->central = centralRead;
     this->constantRequests = requests;
     this->processed = false;
     this->graph = graphRead;
     this->graphName = graphPath.substr(graphPath.find_last_of('/') + 1);
+    this->graphPath = graphPath;
     this->viewer->drawFromThread(this->graph);
     this->processed = false;
 
@@ -155,25 +194,36 @@ bool MeatWagons::setGraph(const string graphPath) {
 
 /**
  * Pre processes graph and eliminates all the requests in which the destination is a node that was removed
- * after the pre processement of the graph
+ * after the pre processement of the graph (there is no path between the central and it). The remaining requests keep the index of their destination,
+ * so the dispatch doesn't need to look up ids again
  * @param node to be processed
  * @return
  */
 bool MeatWagons::preProcess(const int node, const bool draw) {
     if(this->graph == nullptr) return false;
-    if(!this->graph->preProcess(node)) return false;
-    if(!this->graph->dijkstraOriginal(central)) return false;
+    joinDrawing();
 
+    // the central must be in the component that is kept, otherwise no delivery could be planned
+    vector<int> component, componentSizes;
+    this->graph->findComponents(component, componentSizes, false);
+    int nodeIndex = this->graph->findVertexIndex(node), centralIndex = this->graph->findVertexIndex(central);
+    if(nodeIndex == -1 || centralIndex == -1 || component[nodeIndex] != component[centralIndex]) return false;
 
+    if(!this->graph->preProcess(node)) return false;
+    if(!updateCentralTree()) return false;
+
+    // the vertexes removed by the graph were deleted, so the points of interest are collected again
+    this->pointsOfInterest.clear();
     for(int i = 0; i < this->requests.size(); i++) {
         auto it = next(this->requests.begin(), i);
         Request *r = *it;
-        Vertex *vert = this->graph->findVertex((r)->getDest());
-        if(vert == nullptr) {
+        int index = this->graph->findVertexIndex((r)->getDest());
+        if(index == -1) {
             this->requests.erase(it);
             i--;
         } else {
-            this->pointsOfInterest.push_back(vert);
+            r->setDestIndex(index);
+            this->pointsOfInterest.push_back(this->graph->getVertex(index));
         }
     }
 
@@ -182,6 +232,22 @@ bool MeatWagons::preProcess(const int node, const bool draw) {
     return true;
 }
 
+/**
+ * @brief Makes the graph use the shortest path tree of the current central. The tree is kept in memory for every
+ * central used, and saved in the folder of the map, so the next time the same map is loaded and pre processed
+ * the tree is mapped from the file instead of searched again
+ * @return true upon success
+ */
+bool MeatWagons::updateCentralTree() {
+    string file = this->graphPath + "/central" + to_string(this->central) + ".spt";
+    if(this->graph->loadCentralTree(file, this->central)) return true;
+    if(!this->graph->dijkstraOriginal(this->central)) return false;
+
+    // a map folder that can't be written only loses the cache
+    this->graph->saveCentralTree(file);
+    return true;
+}
+
 /**
  * @brief Calculates the shortest path from one point to another with different algorithms
  * @param option - integer representing the algorithm to be used
@@ -190,12 +256,16 @@ bool MeatWagons::preProcess(const int node, const bool draw) {
  */
 bool MeatWagons::shortestPath(const int option, const int origin, const int dest) {
     if(this->graph == nullptr) return false;
+    joinDrawing();
 
     unordered_set<int> processedEdges, processedEdgesInv;
     switch (option) {
         case 1: if (!this->graph->dijkstra(origin, dest, processedEdges)) return false; break;
         case 2: if (!this->graph->dijkstraOrientedSearch(origin, dest, processedEdges)) return false; break;
         case 3: if (!this->graph->dijkstraBidirectional(origin, dest, processedEdges, processedEdgesInv)) return false; break;
+        case 4: if (!this->graph->contractionHierarchySearch(origin, dest, processedEdges)) return false; break;
+        case 5: if (!this->graph->dijkstraArcFlags(origin, dest, processedEdges)) return false; break;
+        case 6: if (!this->graph->customizableHierarchySearch(origin, dest, processedEdges)) return false; break;
     }
 
     vector<Edge> edges;
@@ -205,11 +275,49 @@ bool MeatWagons::shortestPath(const int option, const int origin, const int dest
     return true;
 }
 
+/**
+ * @brief Empties the wagons (deliveries and available time), keeping their ids and capacities
+ */
+void MeatWagons::resetWagons() {
+    multiset<Wagon> emptyWagons;
+    for(const Wagon &wagon : this->wagons)
+        emptyWagons.insert(Wagon(wagon.getId(), wagon.getCapacity()));
+    this->wagons = move(emptyWagons);
+}
+
+/**
+ * @brief Computes the paths between every pair of points the wagons may travel between (the central and the points
+ * of interest), with one search per point running in parallel, so the dispatch reads them instead of searching for each trip
+ * @return true upon success
+ */
+bool MeatWagons::buildDispatchMatrix() {
+    vector<int> points;
+    points.push_back(central);
+    for(Vertex *vertex : this->pointsOfInterest)
+        points.push_back(vertex->getId());
+
+    return this->graph->poiMatrix(this->dispatchMatrix, points);
+}
+
+/**
+ * @brief Length of the shortest path by road between two vertexes, read from the dispatch matrix when both are
+ * points of interest (otherwise given by the hub labels of the graph)
+ * @param origin - vertex where the path starts
+ * @param dest - vertex where the path ends
+ * @return the length of the path
+ */
+double MeatWagons::roadDistance(Vertex *origin, Vertex *dest) const {
+    int source = this->dispatchMatrix.findPoint(origin->getIndex()), target = this->dispatchMatrix.findPoint(dest->getIndex());
+    if(source == -1 || target == -1) return this->graph->hubLabelDistance(origin, dest);
+    return this->dispatchMatrix.distance(source, target);
+}
+
 /**
  * Controls which iteration is to be used
  * @param iteration - number of the iteration to use
  */
 bool MeatWagons::deliver(int iteration) {
+    joinDrawing();
     if(!this->processed) this->preProcess(central, false);
     if(this->constantRequests.size() == 0) return false;
     if(this->requests.size() == 0) {
@@ -217,15 +325,23 @@ bool MeatWagons::deliver(int iteration) {
         for (int i = 0; i < this->requests.size(); i++) {
             auto it = next(this->requests.begin(), i);
             Request *r = *it;
-            Vertex *vert = this->graph->findVertex((r)->getDest());
-            if (vert == nullptr) {
+            int index = this->graph->findVertexIndex((r)->getDest());
+            if (index == -1) {
                 this->requests.erase(it);
                 i--;
             }
-            else this->pointsOfInterest.push_back(vert);
+            else {
+                r->setDestIndex(index);
+                this->pointsOfInterest.push_back(this->graph->getVertex(index));
+            }
         }
     }
 
+    // the deliveries of the previous dispatch are released and the wagons start empty
+    resetWagons();
+    this->deliveryArena.clear();
+    if(!buildDispatchMatrix()) return false;
+
     switch (iteration) {
         case 1: return this->firstIteration();
         case 2: return this->secondIteration();
@@ -258,26 +374,28 @@ int MeatWagons::chooseDropOff(const vector<Vertex*> &pickupNodes) {
 }
 
 /**
- * @brief Groups a number of requests together, based on their distance to one another
+ * @brief Groups a number of requests together, based on their distance to one another.
+ * The distances are the lengths of the shortest paths by road, read from the dispatch matrix
  * @param capacity - number of requests to be grouped
  * @return a vector containing pointers to the requests that were grouped
  */
 vector<Request *> MeatWagons::groupRequests(const int capacity){
     // Initialize the vector where we will put the grouped requests
     vector <Request *> group;
-    int max_dist = 0, dist, pos = 0, max_dist_request_pos = 0;
+    double max_dist = 0, dist;
+    int pos = 0, max_dist_request_pos = 0;
     auto it = requests.begin();
     // We start with the first request since they are ordered by the arrival
-    Vertex* initial_vert = this->graph->findVertex((*it)->getDest());
+    Vertex* initial_vert = this->graph->getVertex((*it)->getDestIndex());
     group.push_back((*it));
     it++;
     // Iterate over the requests to find the nearest to the first one
     while(it != requests.end()) {
         // Get the vertex of the pick up node related to the request
-        Vertex *vert = this->graph->findVertex((*it)->getDest());
+        Vertex *vert = this->graph->getVertex((*it)->getDestIndex());
 
         // Calculate its distance to the first request
-        dist = vert->getPosition().euclideanDistance(initial_vert->getPosition());
+        dist = roadDistance(vert, initial_vert);
 
         if(dist >= this->zoneMaxDist) { it++; continue; };
 
@@ -314,8 +432,8 @@ vector<Request *> MeatWagons::groupRequests(const int capacity){
 
             // Check if there is a request with a bigger distance then the new request
             for(auto itr = 0; itr < group.size(); itr++) {
-                auto *vertex = this->graph->findVertex(group[0]->getDest());
-                dist = vertex->getPosition().euclideanDistance(initial_vert->getPosition());
+                auto *vertex = this->graph->getVertex(group[0]->getDestIndex());
+                dist = roadDistance(vertex, initial_vert);
 
                 if(dist > max_dist) {
                     max_dist = dist;
@@ -334,17 +452,17 @@ vector<Request *> MeatWagons::groupRequests(const int capacity){
 }
 
 /**
- * @brief finds the closest node to a specific node
+ * @brief finds the closest node to a specific node, by road (using the dispatch matrix)
  * @param node - vertex use as a reference to calculate de distance
  * @param neighbours - vector of vertex containing other nodes
  * @return a pointer to the vertex closest to the given node
  */
 Vertex* MeatWagons::getNearestNeighbour(Vertex *node,  const vector<Vertex*> &neighbours) {
-    double nearestDistance = this->graph->findVertex(node->getId())->getPosition().euclideanDistance((*neighbours.begin())->getPosition());
+    double nearestDistance = roadDistance(node, *neighbours.begin());
     auto nearestNeighbour = *neighbours.begin();
 
     for(auto it = ++neighbours.begin(); it != neighbours.end(); it++) {
-        auto currDistance = this->graph->findVertex(node->getId())->getPosition().euclideanDistance((*it)->getPosition());
+        double currDistance = roadDistance(node, *it);
         if(currDistance < nearestDistance) {
             nearestDistance = currDistance;
             nearestNeighbour = *it;
@@ -370,7 +488,7 @@ Request *MeatWagons::findRequest(Vertex* vert, vector<Request*> reqs) {
 }
 
 /**
- * @brief Calculates the shortest path passing through various points using dijkstra bidirectional
+ * @brief Calculates the shortest path passing through various points using the paths of the dispatch matrix
  * @param tspNodes - vector of all the vertex that the wagon must pass by
  * @param reqs - vector of all the reqs that are used in this ride
  * @param tspPath - vector of edges that are passed through
@@ -379,7 +497,6 @@ Request *MeatWagons::findRequest(Vertex* vert, vector<Request*> reqs) {
  * @return - integer representing the distance from the central to the drop off node passing through tspNodes
  */
 int MeatWagons::tspPath(vector<Vertex*> &tspNodes, vector<Request *> reqs, vector<Edge> &tspPath, int dropOffNode, Time& startTime){
-    unordered_set <int> processedEdges, processedInvEdges;
     int totalDist = 0;
 
     // Because tspNodes is a vector ordered by dist -> the first element is the closest to the central
@@ -405,9 +522,8 @@ int MeatWagons::tspPath(vector<Vertex*> &tspNodes, vector<Request *> reqs, vecto
         // Get the nearest point
         Vertex *next = getNearestNeighbour(closest, tspNodes);
 
-        //Calculate the distance from the previous point to the new one using Dijkstra Bidirectional
-        this->graph->dijkstraBidirectional(closest->getId(), next->getId(), processedEdges, processedInvEdges);
-        totalDist += this->graph->getPathTo(next->getId(), tspPath);
+        //Calculate the distance from the previous point to the new one
+        totalDist += this->graph->getTablePath(dispatchMatrix, closest->getId(), next->getId(), tspPath);
 
         // Set the real arrival time of the request belonging to that vertex
         r = findRequest(next, reqs);
@@ -419,8 +535,7 @@ int MeatWagons::tspPath(vector<Vertex*> &tspNodes, vector<Request *> reqs, vecto
     }
 
     // Calculate the distance from the last point to the drop off point
-    this->graph->dijkstraBidirectional(closest->getId(), dropOffNode, processedEdges, processedInvEdges);
-    totalDist += this->graph->getPathTo(dropOffNode, tspPath);
+    totalDist += this->graph->getTablePath(dispatchMatrix, closest->getId(), dropOffNode, tspPath);
 
     // Set the real deliver time all the reqs (they are all delivered at the same point so it will be equal to everyone)
     for(Request* req : reqs){
@@ -432,8 +547,8 @@ int MeatWagons::tspPath(vector<Vertex*> &tspNodes, vector<Request *> reqs, vecto
 }
 
 Delivery* MeatWagons::drawDeliveriesFromThread(int wagonIndex, int deliveryIndex) {
-    thread threadProcess(&MeatWagons::drawDeliveries, this, wagonIndex, deliveryIndex);
-    threadProcess.detach();
+    joinDrawing();
+    deliveriesThread = thread(&MeatWagons::drawDeliveries, this, wagonIndex, deliveryIndex);
     return next(this->wagons.begin(), wagonIndex)->getDeliveries().at(deliveryIndex);
 }
 
@@ -442,23 +557,23 @@ bool MeatWagons::drawDeliveries(int wagonIndex, int deliveryIndex) {
 
     this->viewer->newGv();
     Delivery * delivery = next(this->wagons.begin(), wagonIndex)->getDeliveries().at(deliveryIndex);
+    Vertex *dropOff = this->graph->findVertex(delivery->getDropOff());
 
     for(auto request : delivery->getRequests()) {
         stringstream stream;
         stream << request->getRealArrival();
-        this->graph->findVertex(request->getDest())->setTag(Vertex::PICKUP);
+        this->graph->getVertex(request->getDestIndex())->setTag(Vertex::PICKUP);
         this->viewer->getViewer()->setVertexLabel(request->getDest(), request->getPrisoner() + " arrival at: " + stream.str());
-        this->graph->findVertex(delivery->getDropOff())->setTag(Vertex::DROPOFF);
     }
+    dropOff->setTag(Vertex::DROPOFF);
 
     vector<int> path = Edge::getIds(delivery->getForwardPath());
     this->viewer->setPath(path, "blue", true);
     this->viewer->draw(this->graph);
 
-    for(auto request : delivery->getRequests()) {
-        this->graph->findVertex(request->getDest())->setTag(Vertex::INTEREST_POINT);
-        this->graph->findVertex(delivery->getDropOff())->setTag(Vertex::INTEREST_POINT);
-    }
+    for(auto request : delivery->getRequests())
+        this->graph->getVertex(request->getDestIndex())->setTag(Vertex::INTEREST_POINT);
+    dropOff->setTag(Vertex::INTEREST_POINT);
 
     return true;
 }
@@ -468,17 +583,15 @@ bool MeatWagons::drawDeliveries(int wagonIndex, int deliveryIndex) {
 
 /**
  * This iteration 1 wagon with capacity = 1, this is, it only delivers one prisioner at a time
- * It uses dijkstra bidirectional to calculate the shortest path from the central to the drop off node passing through
+ * It uses the paths of the dispatch matrix to go from the central to the drop off node passing through
  * the pick up node and back to the central again.
  */
 bool MeatWagons::firstIteration() {
     if(wagons.size() != 1)  return false;
     if(wagons.begin()->getCapacity() != 1)  return false;
 
-    unordered_set<int> processedEdges, processedInvEdges;
-
     // Initialize the wagons that will be used
-    for(Wagon wagon : this->wagons) wagon.init();
+    resetWagons();
 
     // Iterate until all the requests are processed
     while(!requests.empty()) {
@@ -496,16 +609,14 @@ bool MeatWagons::firstIteration() {
         int distToPrisoner = this->graph->getPathFromCentralTo(request->getDest(), edgesForwardTrip);
 
         // Choose a drop off node
-        int dropOffNode = chooseDropOff({this->graph->findVertex(request->getDest())});
+        int dropOffNode = chooseDropOff({this->graph->getVertex(request->getDestIndex())});
 
         /* Calculate the distance from the prisioner node to the drop off node */
-        this->graph->dijkstraOrientedSearch(request->getDest(), dropOffNode, processedEdges);
-        int dropOffDist = graph->getPathTo(dropOffNode, edgesForwardTrip);
+        int dropOffDist = this->graph->getTablePath(dispatchMatrix, request->getDest(), dropOffNode, edgesForwardTrip);
         int totalDist = dropOffDist + distToPrisoner;
 
         /* Calculate the distance from the drop off node back to the central */
-        this->graph->dijkstraOrientedSearch(dropOffNode, central, processedEdges);
-        totalDist += this->graph->getPathTo(central, edgesForwardTrip);
+        totalDist += this->graph->getTablePath(dispatchMatrix, dropOffNode, central, edgesForwardTrip);
 
         // The wagon leaves either when it returns from a trip or when it as time to travel to the first pick up node
         Time startTime = wagon.getDeliveries().size() > 0 ? wagon.getNextAvailableTime() : request->getArrival() - Time(0, 0, distToPrisoner / averageVelocity);
@@ -519,11 +630,11 @@ bool MeatWagons::firstIteration() {
         vr.push_back(request);
 
         // Create the delivery and add it to the wagon
-        Delivery *delivery = new Delivery(startTime, vr, edgesForwardTrip, totalDist / averageVelocity, dropOffNode, totalDist);
+        Delivery *delivery = this->deliveryArena.create(startTime, vr, edgesForwardTrip, totalDist / averageVelocity, dropOffNode, totalDist);
         wagon.addDelivery(delivery);
 
         // wagon now is back at the central
-        this->wagons.insert(wagon);
+        this->wagons.insert(move(wagon));
         requests.erase(request);
     }
 
@@ -532,17 +643,15 @@ bool MeatWagons::firstIteration() {
 
 /**
  * This iteration 1 wagon with capacity > 1 to deliver the prisioners.
- * It uses dijkstra bidirectional to calculate the shortest path through all the nodes that it needs to pass
+ * It uses the paths of the dispatch matrix to find the shortest path through all the nodes that it needs to pass
  * from the central to the drop Off node and back to the central.
  */
 bool MeatWagons::secondIteration() {
     if(wagons.size() != 1)  return false;
     if(wagons.begin()->getCapacity() <= 1)  return false;
 
-    unordered_set<int> processedEdges, processedInvEdges;
-
     // Initialize the wagons that will be used
-    for(Wagon wagon : this->wagons) wagon.init();
+    resetWagons();
 
     while(!requests.empty()) {
         // Get the wagon that has the maximum capacity (the wagons are ordered)
@@ -557,7 +666,7 @@ bool MeatWagons::secondIteration() {
         // Populates the tspNodes with the vertex where the prisioners are
         vector<Vertex*> tspNodes;
         for(auto r : groupedRequests) {
-            Vertex *tspNode = this->graph->findVertex(r->getDest());
+            Vertex *tspNode = this->graph->getVertex(r->getDestIndex());
             tspNodes.push_back(tspNode);
         }
 
@@ -569,20 +678,19 @@ bool MeatWagons::secondIteration() {
         int dropOffNode = chooseDropOff(tspNodes);
         vector<Edge> tspPath;
 
-        // Calculate the distance using dijkstra Bidirectional
+        // Calculate the distance through the pick up nodes
         int totalDist = this->tspPath(tspNodes, groupedRequests, tspPath, dropOffNode, startTime);
 
         // Calculate the distance from the drop off node back to the central
-        this->graph->dijkstraOrientedSearch(dropOffNode, central, processedEdges);
-        totalDist += this->graph->getPathTo(central, tspPath);
+        totalDist += this->graph->getTablePath(dispatchMatrix, dropOffNode, central, tspPath);
         wagon.setNextAvailableTime(startTime + Time(0, 0, totalDist / averageVelocity));
 
         // Add the delivery to the wagon
-        Delivery *delivery = new Delivery(startTime, groupedRequests, tspPath, totalDist / averageVelocity, dropOffNode, totalDist);
+        Delivery *delivery = this->deliveryArena.create(startTime, groupedRequests, tspPath, totalDist / averageVelocity, dropOffNode, totalDist);
         wagon.addDelivery(delivery);
 
         // wagon now is back at the central
-        this->wagons.insert(wagon);
+        this->wagons.insert(move(wagon));
     }
 
     return true;
@@ -590,14 +698,13 @@ bool MeatWagons::secondIteration() {
 
 /**
  * This iteration using more than 1 wagon with different capacity to deliver the prisioners.
- * It uses dijkstra bidirectional to calculate the shortest path through all the nodes that it needs to pass
+ * It uses the paths of the dispatch matrix to find the shortest path through all the nodes that it needs to pass
  * from the central to the drop Off node and back to the central.
  */
 bool MeatWagons::thirdIteration() {
     if(wagons.size() <= 1)  return false;
 
-    unordered_set<int> processedEdges, processedInvEdges;
-    for(Wagon wagon : this->wagons) wagon.init();
+    resetWagons();
 
     while(!requests.empty()) {
         // get wagon with max capacity and the sooner available
@@ -612,7 +719,7 @@ bool MeatWagons::thirdIteration() {
         // Populates the tspNodes with the vertex where the prisioners are
         vector<Vertex*> tspNodes;
         for(auto r : groupedRequests) {
-            Vertex *tspNode = this->graph->findVertex(r->getDest());
+            Vertex *tspNode = this->graph->getVertex(r->getDestIndex());
             tspNodes.push_back(tspNode);
         }
 
@@ -624,20 +731,19 @@ bool MeatWagons::thirdIteration() {
         int dropOffNode = chooseDropOff(tspNodes);
         vector<Edge> tspPath;
 
-        // Calculate the distance using dijkstra Bidirectional
+        // Calculate the distance through the pick up nodes
         int totalDist = this->tspPath(tspNodes, groupedRequests, tspPath, dropOffNode, startTime);
 
         // Calculate the distance from the drop off node back to the central
-        this->graph->dijkstraOrientedSearch(dropOffNode, central, processedEdges);
-        totalDist += this->graph->getPathTo(central, tspPath);
+        totalDist += this->graph->getTablePath(dispatchMatrix, dropOffNode, central, tspPath);
         wagon.setNextAvailableTime(startTime + Time(0, 0, totalDist / averageVelocity));
 
         // Add the delivery to the wagon
-        Delivery *delivery = new Delivery(startTime, groupedRequests, tspPath, totalDist / averageVelocity, dropOffNode, totalDist);
+        Delivery *delivery = this->deliveryArena.create(startTime, groupedRequests, tspPath, totalDist / averageVelocity, dropOffNode, totalDist);
         wagon.addDelivery(delivery);
 
         // wagon now is back at the central
-        this->wagons.insert(wagon);
+        this->wagons.insert(move(wagon));
     }
 
     return true;
@@ -680,7 +786,7 @@ multiset<Wagon>::iterator MeatWagons::getWagon(){
 int MeatWagons::objectiveFunction() {
     int sum = 0;
 
-    for(Wagon w : this->wagons)
+    for(const Wagon &w : this->wagons)
         for(Delivery *d: w.getDeliveries())
             sum += d->getTotalDist() + w.getSpaceLeft();
 
@@ -698,4 +804,13 @@ void MeatWagons::setViewerStatus(bool status) {
     viewer->setStatus(status);
 }
 
+/**
+ * @brief Waits for the drawings started from threads (of the viewer and of the deliveries) to finish, before the
+ * graph, the deliveries or the viewer are changed
+ */
+void MeatWagons::joinDrawing() {
+    if(deliveriesThread.joinable()) deliveriesThread.join();
+    viewer->join();
+}
+
 #endif //MEAT_WAGONS_MEATWAGONS_H
\ No newline at end of file
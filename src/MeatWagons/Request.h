@@ -10,6 +10,7 @@ class Request {
     private:
         string prisoner;
         int dest, priority;
+        int destIndex = -1;     // index of the dest vertex in the graph (set when the request is validated)
         Time arrival, deliver;
         bool assigned = false;
         Time realArrival, realDeliver;
@@ -24,6 +25,8 @@ class Request {
 
         string getPrisoner() const;
         int getDest() const;
+        int getDestIndex() const;
+        void setDestIndex(const int index);
         int getPriority() const;
         Time getArrival() const;
         Time getRealArrival() const;
@@ -43,6 +46,14 @@ int Request::getDest() const {
     return this->dest;
 }
 
+int Request::getDestIndex() const {
+    return this->destIndex;
+}
+
+void Request::setDestIndex(const int index) {
+    this->destIndex = index;
+}
+
 int Request::getPriority() const {
     return this->priority;
 }
@@ -17,7 +17,7 @@ class Wagon {
         int  getCapacity() const;
         Time getNextAvailableTime() const;
         void setNextAvailableTime(const Time &time);
-        const vector<Delivery*> getDeliveries() const;
+        const vector<Delivery*> &getDeliveries() const;
         void addDelivery(Delivery* delivery);
         int getSpaceLeft() const;
 
@@ -41,7 +41,7 @@ void Wagon::setNextAvailableTime(const Time &time) {
     this->nextAvailableTime = time;
 }
 
-const vector<Delivery*> Wagon::getDeliveries() const {
+const vector<Delivery*> &Wagon::getDeliveries() const {
     return this->deliveries;
 }
 
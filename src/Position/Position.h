@@ -39,7 +39,8 @@ void Position::setY(double y) {
 }
 
 double Position::euclideanDistance(const Position &pos2) const {
-    return sqrt(pow(pos2.x - x, 2) + pow(pos2.y - y, 2));
+    double dx = pos2.x - x, dy = pos2.y - y;
+    return sqrt(dx * dx + dy * dy);
 }
 
 double Position::manhattanDistance(const Position &pos2) const {
@@ -0,0 +1,54 @@
+#pragma once
+#ifndef MEAT_WAGONS_TEST_H
+#define MEAT_WAGONS_TEST_H
+
+#include <iostream>
+#include <set>
+#include "../src/MeatWagons/Request.h"
+#include "../src/Graph/Reader.h"
+
+using namespace std;
+
+int failedChecks = 0;       // checks that failed so far, main returns it so the test fails if any did
+
+// Reports a condition that doesn't hold, without stopping the test
+#define CHECK(condition) \
+    do { \
+        if(!(condition)) { \
+            cerr << __FILE__ << ":" << __LINE__ << ": check failed: " << #condition << endl; \
+            failedChecks++; \
+        } \
+    } while(0)
+
+/**
+ * @brief Reads a map of maps/PortugalMaps as it is, without pre processing it (so it keeps all its components)
+ * @param name - name of the map (Fafe, Porto, ...)
+ * @param graph - graph where the map is stored
+ * @param central - id of the central of the map
+ * @return - true if the map was read
+ */
+bool readMap(const string &name, Graph &graph, int &central) {
+    Reader reader("maps/PortugalMaps/" + name);
+    if(reader.readGraph(&graph, central)) return true;
+    cerr << "Can't read maps/PortugalMaps/" << name << " (the tests run from the repository root)" << endl;
+    return false;
+}
+
+/**
+ * @brief Length of the path of the last search of the graph to a vertex
+ * @param graph - graph searched
+ * @param dest - id of the vertex where the path ends
+ * @param numEdges - filled with the number of edges of the path (0 if there is none)
+ * @return - the sum of the weights of the edges of the path
+ */
+double pathLength(const Graph &graph, const int dest, int &numEdges) {
+    vector<Edge> edges;
+    graph.getPathTo(dest, edges);
+    numEdges = edges.size();
+
+    double length = 0;
+    for(const Edge &edge : edges) length += edge.getWeight();
+    return length;
+}
+
+#endif
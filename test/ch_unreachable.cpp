@@ -0,0 +1,59 @@
+#include "Test.h"
+
+/*
+ * The contraction hierarchy search between vertexes of different components must find no path, and between vertexes
+ * of the same component the same length as dijkstra. The maps are read without pre processing, so they keep their
+ * small components.
+ */
+int main() {
+    for(const string map : {"Fafe", "Porto"}) {
+        Graph graph;
+        int central;
+        if(!readMap(map, graph, central)) return 1;
+
+        vector<int> component, sizes;
+        int numComponents = graph.findComponents(component, sizes, false);
+        CHECK(numComponents > 1);
+
+        // the first vertex of each component, the largest one first
+        int largest = max_element(sizes.begin(), sizes.end()) - sizes.begin();
+        vector<int> first(numComponents, -1);
+        for(int index = 0; index < graph.getNumVertex(); index++)
+            if(first[component[index]] == -1) first[component[index]] = graph.getVertex(index)->getId();
+        swap(first[0], first[largest]);
+
+        // a vertex of the largest component against the first vertex of each other one, both ways
+        for(int other = 1; other < numComponents; other++) {
+            unordered_set<int> processedEdges;
+            int numEdges;
+
+            CHECK(graph.contractionHierarchySearch(first[0], first[other], processedEdges));
+            pathLength(graph, first[other], numEdges);
+            CHECK(numEdges == 0);
+
+            CHECK(graph.contractionHierarchySearch(first[other], first[0], processedEdges));
+            pathLength(graph, first[0], numEdges);
+            CHECK(numEdges == 0);
+        }
+
+        // vertexes of the largest component are still reachable from each other
+        const vector<Vertex*> &vertexSet = graph.getVertexSet();
+        for(int i = 0, checked = 0; i < graph.getNumVertex() && checked < 50; i += 97) {
+            int dest = vertexSet[i]->getId();
+            if(component[i] != largest || dest == first[0]) continue;
+            checked++;
+
+            unordered_set<int> processedEdges;
+            int numEdges, chEdges;
+            graph.dijkstra(first[0], dest, processedEdges);
+            double length = pathLength(graph, dest, numEdges);
+            CHECK(graph.contractionHierarchySearch(first[0], dest, processedEdges));
+            double chLength = pathLength(graph, dest, chEdges);
+
+            CHECK(numEdges > 0 && chEdges > 0);
+            CHECK(abs(length - chLength) <= 1e-6 * length);
+        }
+    }
+
+    return failedChecks;
+}
@@ -0,0 +1,125 @@
+#include "Test.h"
+
+/*
+ * setEdgeWeights must change the weight in the csr and in both edge lists of the vertexes, make the searches follow
+ * the new weights (the customizable hierarchy after being customized again) and never the closed edges, drop the
+ * floyd warshall matrix, and change nothing when a weight or an edge is invalid.
+ */
+
+/**
+ * @brief Checks that every outgoing edge has the same weight as its copy in the ingoing edges of its destination
+ * @param graph - graph checked
+ */
+void checkEdgeCopies(const Graph &graph) {
+    for(Vertex *vertex : graph.getVertexSet())
+        for(const Edge &edge : vertex->getAdj()) {
+            int copies = 0;
+            for(const Edge &inEdge : edge.getDest()->getInvAdj())
+                if(inEdge.getId() == edge.getId()) {
+                    CHECK(inEdge.getWeight() == edge.getWeight());
+                    copies++;
+                }
+            CHECK(copies == 1);
+        }
+}
+
+/**
+ * @brief Compares the searches of the graph with dijkstra between pairs of vertexes spread through the map: the
+ * customizable hierarchy, the bidirectional search and the arc flags must find paths as short, the oriented search
+ * no shorter, and none of them can follow a closed edge
+ * @param graph - graph searched
+ */
+void checkSearches(Graph &graph) {
+    const vector<Vertex*> &vertexSet = graph.getVertexSet();
+    int numVertex = graph.getNumVertex();
+    for(int i = 0; i < numVertex; i += 61) {
+        int origin = vertexSet[i]->getId(), dest = vertexSet[(i * 7919 + 13) % numVertex]->getId();
+        if(origin == dest) continue;
+
+        unordered_set<int> processedEdges, processedEdgesInv;
+        int numEdges;
+        graph.dijkstra(origin, dest, processedEdges);
+        double dist = pathLength(graph, dest, numEdges);
+        bool reachable = numEdges > 0;
+
+        for(int algorithm = 0; algorithm < 4; algorithm++) {
+            if(algorithm == 0) graph.customizableHierarchySearch(origin, dest, processedEdges);
+            else if(algorithm == 1) graph.dijkstraOrientedSearch(origin, dest, processedEdges);
+            else if(algorithm == 2) graph.dijkstraBidirectional(origin, dest, processedEdges, processedEdgesInv);
+            else graph.dijkstraArcFlags(origin, dest, processedEdges);
+
+            vector<Edge> edges;
+            graph.getPathTo(dest, edges);
+            CHECK(reachable == !edges.empty());
+
+            double length = 0;
+            for(const Edge &edge : edges) {
+                CHECK(edge.getWeight() != numeric_limits<double>::infinity());
+                length += edge.getWeight();
+            }
+            if(algorithm == 1) CHECK(length >= dist * (1 - 1e-6));
+            else CHECK(abs(length - dist) <= 1e-6 * dist);
+        }
+    }
+}
+
+int main() {
+    // two ways from 1 to 3: through 2 (length 20) and through 4 (about 22.4)
+    Graph graph;
+    graph.addVertex(1, 0, 0);
+    graph.addVertex(2, 10, 0);
+    graph.addVertex(3, 20, 0);
+    graph.addVertex(4, 10, 5);
+    graph.addEdge(12, 1, 2);
+    graph.addEdge(23, 2, 3);
+    graph.addEdge(14, 1, 4);
+    graph.addEdge(43, 4, 3);
+
+    unordered_set<int> processedEdges;
+    int numEdges;
+    CHECK(graph.dijkstra(1, 3, processedEdges));
+    CHECK(abs(pathLength(graph, 3, numEdges) - 20) < 1e-9);
+    graph.floydWarshallShortestPath();
+    CHECK(graph.getfloydWarshallPath(1, 3) == vector<int>({1, 2, 3}));
+
+    // invalid changes are refused as a whole
+    CHECK(!graph.setEdgeWeights({{23, 100}, {99, 1}}));
+    CHECK(!graph.setEdgeWeights({{23, 100}, {12, -1}}));
+    CHECK(graph.getVertex(graph.findVertexIndex(2))->getAdj()[0].getWeight() == 10);
+    CHECK(graph.getfloydWarshallPath(1, 3) == vector<int>({1, 2, 3}));
+
+    CHECK(graph.setEdgeWeights({{23, 100}}));
+    checkEdgeCopies(graph);
+    CHECK(graph.getVertex(graph.findVertexIndex(2))->getAdj()[0].getWeight() == 100);
+    CHECK(graph.getfloydWarshallPath(1, 3).empty());
+
+    CHECK(graph.dijkstra(1, 3, processedEdges));
+    CHECK(abs(pathLength(graph, 3, numEdges) - 2 * sqrt(125.0)) < 1e-9);
+    graph.floydWarshallShortestPath();
+    CHECK(graph.getfloydWarshallPath(1, 3) == vector<int>({1, 4, 3}));
+
+    // the same on a map, where the vertexes were reordered and the ingoing lists aren't in csr order
+    int central;
+    Graph map;
+    if(!readMap("Fafe", map, central)) return 1;
+    map.reorderVertexes(Graph::HILBERT_ORDER);
+
+    vector<pair<int, double>> weights;
+    const vector<Vertex*> &vertexSet = map.getVertexSet();
+    for(int i = 0; i < map.getNumVertex(); i += 11)
+        for(const Edge &edge : vertexSet[i]->getAdj()) weights.push_back(make_pair(edge.getId(), edge.getWeight() * 3));
+    checkSearches(map);
+    CHECK(map.setEdgeWeights(weights));
+    checkEdgeCopies(map);
+    checkSearches(map);
+
+    // roads closed with an infinite weight
+    weights.clear();
+    for(int i = 5; i < map.getNumVertex(); i += 37)
+        for(const Edge &edge : vertexSet[i]->getAdj()) weights.push_back(make_pair(edge.getId(), numeric_limits<double>::infinity()));
+    CHECK(map.setEdgeWeights(weights));
+    checkEdgeCopies(map);
+    checkSearches(map);
+
+    return failedChecks;
+}
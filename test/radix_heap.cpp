@@ -0,0 +1,134 @@
+// the searches of the graph use the radix heap, so this path is built and checked too
+#define GRAPH_RADIX_HEAP
+#include <random>
+#include "Test.h"
+
+/*
+ * The radix heap must extract the same vertexes, in the same order, as the binary heap (MutablePriorityQueue) given
+ * the same monotone sequence of operations, and the searches of the graph must find paths as short as a reference
+ * dijkstra that uses the binary heap (dijkstra and the bidirectional search) or no shorter (the oriented search).
+ */
+
+/**
+ * @brief Runs the same random operations on a binary heap and on a radix heap: inserts of new vertexes and decreases
+ * of the keys of queued vertexes, never below the last key extracted (like dijkstra), and extractions
+ * @param seed - seed of the operations
+ * @param numVertex - number of vertexes that can be inserted
+ */
+void compareQueues(const unsigned seed, const int numVertex) {
+    mt19937 random(seed);
+    uniform_real_distribution<double> step(0, 50);
+
+    vector<double> binaryKey(numVertex), radixKey(numVertex);
+    vector<int> binaryIndex(numVertex, 0), radixIndex(numVertex, 0);
+    vector<int> state(numVertex, 0);        // 0 never inserted, 1 in the queues, 2 extracted
+    MutablePriorityQueue<double> binary(binaryKey, binaryIndex);
+    RadixHeap radix(radixKey, radixIndex);
+
+    double last = 0;
+    int queued = 0, extracted = 0;
+    while(extracted < numVertex) {
+        int vertex = random() % numVertex;
+
+        if(state[vertex] == 0) {
+            binaryKey[vertex] = radixKey[vertex] = last + step(random);
+            binary.insert(vertex);
+            radix.insert(vertex);
+            state[vertex] = 1;
+            queued++;
+        }
+        else if(state[vertex] == 1 && random() % 2 == 0) {
+            binaryKey[vertex] = radixKey[vertex] = last + (binaryKey[vertex] - last) * (random() % 1000) / 1000.0;
+            binary.decreaseKey(vertex);
+            radix.decreaseKey(vertex);
+        }
+        else if(queued > 0) {
+            CHECK(!binary.empty() && !radix.empty());
+            int binaryMin = binary.extractMin(), radixMin = radix.extractMin();
+            CHECK(binaryMin == radixMin);
+            CHECK(binaryKey[binaryMin] >= last);
+            CHECK(radixIndex[radixMin] == 0);
+
+            last = binaryKey[binaryMin];
+            state[binaryMin] = 2;
+            queued--;
+            extracted++;
+        }
+    }
+
+    CHECK(binary.empty() && radix.empty());
+}
+
+/**
+ * @brief Dijkstra from a vertex to every other one, following the edges in both directions like the searches of
+ * the graph, with the binary heap
+ * @param graph - graph searched
+ * @param source - index of the vertex where the search starts
+ * @return - distance of each vertex to the source (infinity if it isn't reachable)
+ */
+vector<double> referenceDistances(const Graph &graph, const int source) {
+    int numVertex = graph.getNumVertex();
+    vector<vector<pair<int, double>>> neighbours(numVertex);
+    for(Vertex *vertex : graph.getVertexSet())
+        for(const Edge &edge : vertex->getAdj()) {
+            neighbours[vertex->getIndex()].push_back(make_pair(edge.getDest()->getIndex(), edge.getWeight()));
+            neighbours[edge.getDest()->getIndex()].push_back(make_pair(vertex->getIndex(), edge.getWeight()));
+        }
+
+    vector<double> dist(numVertex, numeric_limits<double>::infinity());
+    vector<int> queueIndex(numVertex, 0);
+    MutablePriorityQueue<double> queue(dist, queueIndex);
+    dist[source] = 0;
+    queue.insert(source);
+
+    while(!queue.empty()) {
+        int vertex = queue.extractMin();
+        for(const pair<int, double> &next : neighbours[vertex])
+            if(dist[vertex] + next.second < dist[next.first]) {
+                bool queued = dist[next.first] != numeric_limits<double>::infinity();
+                dist[next.first] = dist[vertex] + next.second;
+                if(queued) queue.decreaseKey(next.first);
+                else queue.insert(next.first);
+            }
+    }
+
+    return dist;
+}
+
+int main() {
+    for(unsigned seed = 1; seed <= 200; seed++)
+        compareQueues(seed, 1 + seed * 10);
+
+    for(const string map : {"Fafe", "Porto"}) {
+        Graph graph;
+        int central;
+        if(!readMap(map, graph, central)) return 1;
+
+        int source = graph.findVertexIndex(central);
+        vector<double> dist = referenceDistances(graph, source);
+
+        const vector<Vertex*> &vertexSet = graph.getVertexSet();
+        for(int dest = 0; dest < graph.getNumVertex(); dest += 53) {
+            int destId = vertexSet[dest]->getId();
+            bool reachable = dist[dest] != numeric_limits<double>::infinity();
+
+            for(int algorithm = 0; algorithm < 3; algorithm++) {
+                unordered_set<int> processedEdges, processedEdgesInv;
+                if(algorithm == 0) graph.dijkstra(central, destId, processedEdges);
+                else if(algorithm == 1) graph.dijkstraOrientedSearch(central, destId, processedEdges);
+                else graph.dijkstraBidirectional(central, destId, processedEdges, processedEdgesInv);
+
+                int numEdges;
+                double length = pathLength(graph, destId, numEdges);
+                CHECK(reachable == (numEdges > 0 || dest == source));
+                if(!reachable) continue;
+
+                // the oriented search can end with a slightly longer path (with either queue), never a shorter one
+                if(algorithm == 1) CHECK(length >= dist[dest] * (1 - 1e-6));
+                else CHECK(abs(length - dist[dest]) <= 1e-6 * dist[dest]);
+            }
+        }
+    }
+
+    return failedChecks;
+}
@@ -0,0 +1,98 @@
+#include <fstream>
+#include <iterator>
+#include "Test.h"
+
+/*
+ * A tree saved by saveCentralTree must load into another graph of the same map and give the same paths, and a file
+ * that was truncated or damaged must be refused (so the tree is computed again) instead of being followed.
+ */
+
+/**
+ * @brief Reads a whole file
+ * @param file - path of the file
+ * @return - bytes of the file
+ */
+vector<char> readFile(const string &file) {
+    ifstream stream(file, ios::binary);
+    return vector<char>(istreambuf_iterator<char>(stream), istreambuf_iterator<char>());
+}
+
+/**
+ * @brief Writes bytes to a file, replacing it
+ * @param file - path of the file
+ * @param bytes - bytes to write
+ */
+void writeFile(const string &file, const vector<char> &bytes) {
+    ofstream stream(file, ios::binary | ios::trunc);
+    stream.write(bytes.data(), bytes.size());
+}
+
+/**
+ * @brief Checksum of the arrays of a saved tree, the same one the tree stores in its header, so a file can be
+ * changed and still pass it
+ * @param bytes - bytes of the file
+ * @return - the checksum of the bytes after the header
+ */
+uint64_t arraysChecksum(const vector<char> &bytes) {
+    uint64_t hash = 14695981039346656037ULL;
+    for(size_t i = 32; i < bytes.size(); i++) {
+        hash ^= (unsigned char) bytes[i];
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+int main(int, char *argv[]) {
+    // the files are written next to the test executable, not in the repository
+    string program = argv[0], file = program.substr(0, program.find_last_of("/\\") + 1) + "shortest_path_tree.spt";
+
+    Graph graph, loaded;
+    int central;
+    if(!readMap("Fafe", graph, central) || !readMap("Fafe", loaded, central)) return 1;
+    CHECK(graph.dijkstraOriginal(central));
+    CHECK(graph.saveCentralTree(file));
+
+    // the loaded tree gives the same paths as the computed one
+    CHECK(loaded.loadCentralTree(file, central));
+    const vector<Vertex*> &vertexSet = graph.getVertexSet();
+    for(int i = 0; i < graph.getNumVertex(); i += 7) {
+        vector<Edge> edges, loadedEdges;
+        int dest = vertexSet[i]->getId();
+        CHECK(graph.getPathFromCentralTo(dest, edges) == loaded.getPathFromCentralTo(dest, loadedEdges));
+        CHECK(edges.size() == loadedEdges.size());
+        for(size_t edge = 0; edge < edges.size() && edge < loadedEdges.size(); edge++)
+            CHECK(edges[edge].getId() == loadedEdges[edge].getId());
+    }
+
+    // header: magic, numVertex, root, numArcs, graph checksum and arrays checksum, then dist, path and edgePath
+    const vector<char> bytes = readFile(file);
+    int numVertex = graph.getNumVertex();
+    size_t pathOffset = 32 + 8 * (size_t) numVertex;
+    CHECK(bytes.size() == pathOffset + 8 * (size_t) numVertex);
+
+    vector<vector<char>> damaged;
+    damaged.push_back(vector<char>(bytes.begin(), bytes.end() - 4));                    // truncated
+    damaged.push_back(bytes);                                                           // a byte of a path changed
+    damaged.back()[pathOffset + 4 * (numVertex / 2)] ^= 0x40;
+
+    // parents outside the graph, and a vertex that is its own parent, with the arrays checksum updated to match
+    for(int32_t parent : {numVertex, -2, numVertex / 3}) {
+        damaged.push_back(bytes);
+        memcpy(&damaged.back()[pathOffset + 4 * (numVertex / 3)], &parent, 4);
+        uint64_t checksum = arraysChecksum(damaged.back());
+        memcpy(&damaged.back()[24], &checksum, 8);
+    }
+
+    for(const vector<char> &damagedBytes : damaged) {
+        Graph other;
+        if(!readMap("Fafe", other, central)) return 1;
+        writeFile(file, damagedBytes);
+        CHECK(!other.loadCentralTree(file, central));
+
+        vector<Edge> edges;
+        CHECK(!other.getPathFromCentralTo(vertexSet[numVertex / 3]->getId(), edges));
+    }
+
+    remove(file.c_str());
+    return failedChecks;
+}